@@ -8,10 +8,13 @@
 
 #include <cstddef>
 #include <chrono>
+#include <new>
 
 #include <boost/config.hpp>
 #include <boost/assert.hpp>
+#include <boost/intrusive/list.hpp>
 
+#include <boost/fiber/context.hpp>
 #include <boost/fiber/properties.hpp>
 #include <boost/fiber/detail/config.hpp>
 
@@ -22,13 +25,22 @@
 namespace boost {
 namespace fibers {
 
-class context;
-
 struct BOOST_FIBERS_DECL sched_algorithm {
+    typedef intrusive::list<
+                context,
+                intrusive::member_hook<
+                    context, detail::ready_hook, & context::ready_hook_ >,
+                intrusive::constant_time_size< false > >    ready_queue_type;
+
     virtual ~sched_algorithm() {}
 
     virtual void awakened( context *) noexcept = 0;
 
+    // takes all context' of the batch (linked by their ready-hook),
+    // the batch is empty afterwards
+    // default: calls awakened() for each context
+    virtual void awakened_batch( ready_queue_type &) noexcept;
+
     virtual context * pick_next() noexcept = 0;
 
     virtual bool has_ready_fibers() const noexcept = 0;
@@ -43,9 +55,16 @@ public:
     // called by fiber_properties::notify() -- don't directly call
     virtual void property_change_( context * f, fiber_properties * props) noexcept = 0;
 
+    // bytes reserved for the properties on the stack of each fiber
+    // created in a thread using this algorithm
+    virtual std::size_t properties_size() const noexcept = 0;
+
 protected:
     static fiber_properties* get_properties( context * f) noexcept;
     static void set_properties( context * f, fiber_properties * p) noexcept;
+    // storage reserved on the fiber's stack, nullptr if none was reserved
+    // or if it is smaller than size
+    static void * get_properties_storage( context * f, std::size_t size, std::size_t alignment) noexcept;
 };
 
 template< typename PROPS >
@@ -59,8 +78,6 @@ struct sched_algorithm_with_properties : public sched_algorithm_with_properties_
     virtual void awakened( context * f) noexcept override final {
         fiber_properties * props = super::get_properties( f);
         if ( nullptr == props) {
-            // TODO: would be great if PROPS could be allocated on the new
-            // fiber's stack somehow
             props = new_properties( f);
             // It is not good for new_properties() to return 0.
             BOOST_ASSERT_MSG(props, "new_properties() must return non-NULL");
@@ -95,10 +112,23 @@ struct sched_algorithm_with_properties : public sched_algorithm_with_properties_
         property_change( f, * static_cast< PROPS * >( props) );
     }
 
+    // implementation for sched_algorithm_with_properties_base method,
+    // override this if new_properties() constructs a larger subclass of PROPS
+    std::size_t properties_size() const noexcept override {
+        return sizeof( PROPS);
+    }
+
     // Override this to customize instantiation of PROPS, e.g. use a different
     // allocator. Each PROPS instance is associated with a particular
     // context.
+    // default: PROPS is constructed in the storage reserved on the fiber's
+    // stack, or on the heap if the fiber has been created in a thread with
+    // a different scheduling algorithm
     virtual fiber_properties * new_properties( context * f) noexcept {
+        void * storage = super::get_properties_storage( f, sizeof( PROPS), alignof( PROPS) );
+        if ( nullptr != storage) {
+            return ::new ( storage) PROPS( f);
+        }
         return new PROPS( f);
     }
 };
@@ -12,19 +12,35 @@
 #include <boost/fiber/bounded_channel.hpp>
 #include <boost/fiber/condition_variable.hpp>
 #include <boost/fiber/context.hpp>
+#include <boost/fiber/counting_semaphore.hpp>
+#include <boost/fiber/earliest_deadline_first.hpp>
 #include <boost/fiber/exceptions.hpp>
 #include <boost/fiber/fiber.hpp>
+#include <boost/fiber/fiber_pool.hpp>
 #include <boost/fiber/fixedsize_stack.hpp>
 #include <boost/fiber/future.hpp>
 #include <boost/fiber/fss.hpp>
+#include <boost/fiber/latch.hpp>
+#if ! defined(BOOST_WINDOWS)
+#include <boost/fiber/lazy_fixedsize_stack.hpp>
+#include <boost/fiber/numa_fixedsize_stack.hpp>
+#endif
 #include <boost/fiber/mutex.hpp>
 #include <boost/fiber/operations.hpp>
+#include <boost/fiber/pooled_fixedsize_stack.hpp>
+#include <boost/fiber/priority_round_robin.hpp>
 #include <boost/fiber/protected_fixedsize_stack.hpp>
+#include <boost/fiber/protected_pooled_fixedsize_stack.hpp>
 #include <boost/fiber/recursive_mutex.hpp>
 #include <boost/fiber/recursive_timed_mutex.hpp>
+#include <boost/fiber/runtime.hpp>
 #include <boost/fiber/scheduler.hpp>
 #include <boost/fiber/segmented_stack.hpp>
+#include <boost/fiber/shared_mutex.hpp>
+#include <boost/fiber/shared_timed_mutex.hpp>
 #include <boost/fiber/timed_mutex.hpp>
+#include <boost/fiber/trace.hpp>
 #include <boost/fiber/unbounded_channel.hpp>
+#include <boost/fiber/work_stealing.hpp>
 
 #endif // BOOST_FIBERS_H
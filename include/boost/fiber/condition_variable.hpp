@@ -70,7 +70,11 @@ public:
         BOOST_ASSERT( ! ctx->wait_is_linked() );
         ctx->wait_link( wait_queue_);
         // unlock external lt
+        // a fiber waiting for lt must not be resumed directly,
+        // it might call notify_one() while lk is held
+        ctx->handoff_blocked( true);
         lt.unlock();
+        ctx->handoff_blocked( false);
         // suspend this fiber
         ctx->suspend( lk);
         // relock local lk
@@ -112,7 +116,11 @@ public:
         BOOST_ASSERT( ! ctx->wait_is_linked() );
         ctx->wait_link( wait_queue_);
         // unlock external lt
+        // a fiber waiting for lt must not be resumed directly,
+        // it might call notify_one() while lk is held
+        ctx->handoff_blocked( true);
         lt.unlock();
+        ctx->handoff_blocked( false);
         // suspend this fiber
         if ( ! ctx->wait_until( timeout_time, lk) ) {
             status = cv_status::timeout;
@@ -182,22 +190,22 @@ public:
     void wait( std::unique_lock< mutex > & lt) {
         // pre-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
         cnd_.wait( lt);
         // post-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
     }
 
     template< typename Pred >
     void wait( std::unique_lock< mutex > & lt, Pred pred) {
         // pre-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
         cnd_.wait( lt, pred);
         // post-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
     }
 
     template< typename Clock, typename Duration >
@@ -205,11 +213,11 @@ public:
                           std::chrono::time_point< Clock, Duration > const& timeout_time) {
         // pre-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
         cv_status result = cnd_.wait_until( lt, timeout_time);
         // post-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
         return result;
     }
 
@@ -218,11 +226,11 @@ public:
                      std::chrono::time_point< Clock, Duration > const& timeout_time, Pred pred) {
         // pre-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
         bool result = cnd_.wait_until( lt, timeout_time, pred);
         // post-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
         return result;
     }
 
@@ -231,11 +239,11 @@ public:
                         std::chrono::duration< Rep, Period > const& timeout_duration) {
         // pre-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
         cv_status result = cnd_.wait_for( lt, timeout_duration);
         // post-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
         return result;
     }
 
@@ -244,11 +252,11 @@ public:
                    std::chrono::duration< Rep, Period > const& timeout_duration, Pred pred) {
         // pre-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
         bool result = cnd_.wait_for( lt, timeout_duration, pred);
         // post-condition
         BOOST_ASSERT( lt.owns_lock() );
-        BOOST_ASSERT( context::active() == lt.mutex()->owner_);
+        BOOST_ASSERT( context::active() == lt.mutex()->impl_.owner() );
         return result;
     }
 };
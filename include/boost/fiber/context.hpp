@@ -9,11 +9,13 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <functional>
-#include <map>
 #include <memory>
 #include <type_traits>
+#include <vector>
 
 #include <boost/assert.hpp>
 #include <boost/config.hpp>
@@ -28,6 +30,8 @@
 #include <boost/fiber/detail/config.hpp>
 #include <boost/fiber/detail/decay_copy.hpp>
 #include <boost/fiber/detail/fss.hpp>
+#include <boost/fiber/detail/mpsc_queue.hpp>
+#include <boost/fiber/detail/pool_task.hpp>
 #include <boost/fiber/detail/spinlock.hpp>
 #include <boost/fiber/detail/wrap.hpp>
 #include <boost/fiber/exceptions.hpp>
@@ -49,6 +53,8 @@ class scheduler;
 
 namespace detail {
 
+class context_pool;
+
 struct wait_tag;
 typedef intrusive::list_member_hook<
     intrusive::tag< wait_tag >,
@@ -82,21 +88,25 @@ typedef intrusive::list_member_hook<
     >
 >                                       ready_hook;
 
-struct remote_ready_tag;
+typedef mpsc_hook< context >             remote_ready_hook;
+
+struct sleep_tag;
+#if defined(BOOST_FIBERS_USE_TIMER_WHEEL)
+// slot of detail::timer_wheel
 typedef intrusive::list_member_hook<
-    intrusive::tag< remote_ready_tag >,
+    intrusive::tag< sleep_tag >,
     intrusive::link_mode<
         intrusive::auto_unlink
     >
->                                       remote_ready_hook;
-
-struct sleep_tag;
+>                                       sleep_hook;
+#else
 typedef intrusive::set_member_hook<
     intrusive::tag< sleep_tag >,
     intrusive::link_mode<
         intrusive::auto_unlink
     >
 >                                       sleep_hook;
+#endif
 
 struct terminated_tag;
 typedef intrusive::list_member_hook<
@@ -125,10 +135,14 @@ const dispatcher_context_t dispatcher_context{};
 struct worker_context_t {};
 const worker_context_t worker_context{};
 
+struct pooled_context_t {};
+const pooled_context_t pooled_context{};
+
 class BOOST_FIBERS_DECL context {
 private:
     friend struct context_initializer;
     friend class scheduler;
+    friend class detail::context_pool;
 
     enum flag_t {
         flag_main_context           = 1 << 1,
@@ -136,7 +150,9 @@ private:
         flag_worker_context         = 1 << 3,
         flag_terminated             = 1 << 4,
         flag_interruption_blocked   = 1 << 5,
-        flag_interruption_requested = 1 << 6
+        flag_interruption_requested = 1 << 6,
+        flag_queued                 = 1 << 7,
+        flag_handoff_blocked        = 1 << 8
     };
 
     struct BOOST_FIBERS_DECL fss_data {
@@ -172,16 +188,16 @@ private:
         }
     };
 
-    typedef std::map< uintptr_t, fss_data >     fss_data_t;
+    typedef std::vector< fss_data >             fss_data_t;
 
     static thread_local context         *   active_;
 
+    // members up to sctx_ are accessed by the thread
+    // running the scheduler of this context
 #if ! defined(BOOST_FIBERS_NO_ATOMICS)
     std::atomic< std::size_t >              use_count_{ 0 };
-    std::atomic< int >                      flags_;
 #else
     std::size_t                             use_count_{ 0 };
-    int                                     flags_;
 #endif
     scheduler                           *   scheduler_{ nullptr };
     boost::context::execution_context       ctx_;
@@ -189,6 +205,13 @@ private:
     void resume_( data_t &) noexcept;
     void set_ready_( context *) noexcept;
 
+    // entry function of a pooled context: runs the bound task,
+    // terminates and waits to be recycled
+    void run_pooled_( data_t *) noexcept;
+
+    // returns the context to its pool or destroys it
+    void release_() noexcept;
+
     template< typename Fn, typename Tpl >
     void run_( Fn && fn_, Tpl && tpl_, data_t * dp) noexcept {
         try {
@@ -209,10 +232,8 @@ private:
 
 public:
     detail::ready_hook                      ready_hook_{};
-    detail::remote_ready_hook               remote_ready_hook_{};
     detail::sleep_hook                      sleep_hook_{};
     detail::terminated_hook                 terminated_hook_{};
-    detail::wait_hook                       wait_hook_{};
     detail::worker_hook                     worker_hook_{};
     std::chrono::steady_clock::time_point   tp_{ (std::chrono::steady_clock::time_point::max)() };
 
@@ -222,10 +243,35 @@ public:
         intrusive::constant_time_size< false > >   wait_queue_t;
 
 private:
+    // fiber-specific storage, indexed by the key of fiber_specific_ptr
+    // the first slots are stored inline, further slots on the heap
+    fss_data                                fss_inline_[BOOST_FIBERS_FSS_INLINE_SLOTS]{};
     fss_data_t                              fss_data_{};
-    wait_queue_t                            wait_queue_{};
-    detail::spinlock                        splk_{};
     fiber_properties                    *   properties_{ nullptr };
+    // storage for the properties reserved on the stack of a worker context
+    void                                *   properties_storage_{ nullptr };
+    std::size_t                             properties_storage_size_{ 0 };
+    // pool owning this context (if any) and the task bound to it
+    detail::context_pool                *   pool_{ nullptr };
+    detail::pool_task                   *   task_{ nullptr };
+    // stack of worker and dispatcher context' (sp == nullptr for the
+    // main context)
+    boost::context::stack_context           sctx_{};
+
+    // members written by other threads (remote wakeup, fibers joining
+    // or waking this context, work-stealing) start at a separate cache
+    // line, stores of other CPUs do not invalidate the members above
+#if ! defined(BOOST_FIBERS_NO_ATOMICS)
+    alignas(BOOST_FIBERS_CACHELINE_LENGTH) std::atomic< int >   flags_;
+#else
+    alignas(BOOST_FIBERS_CACHELINE_LENGTH) int                  flags_;
+#endif
+    detail::spinlock                        splk_{};
+    wait_queue_t                            wait_queue_{};
+
+public:
+    detail::remote_ready_hook               remote_ready_hook_{};
+    detail::wait_hook                       wait_hook_{};
 
 public:
     class id {
@@ -302,7 +348,6 @@ public:
              boost::context::preallocated palloc, StackAlloc salloc,
              Fn && fn, Tpl && tpl) :
         use_count_{ 1 }, // fiber instance or scheduler owner
-        flags_{ flag_worker_context },
 #if defined(BOOST_NO_CXX14_GENERIC_LAMBDAS)
         ctx_{ std::allocator_arg, palloc, salloc,
               detail::wrap(
@@ -312,15 +357,32 @@ public:
                   },
                   std::forward< Fn >( fn),
                   std::forward< Tpl >( tpl),
-                  boost::context::execution_context::current())}
+                  boost::context::execution_context::current())},
 #else
         ctx_{ std::allocator_arg, palloc, salloc,
               [this,fn=detail::decay_copy( std::forward< Fn >( fn) ),tpl=std::forward< Tpl >( tpl),
                ctx=boost::context::execution_context::current()] (void * vp) mutable noexcept {
                     run_( std::move( fn), std::move( tpl), static_cast< data_t * >( vp) );
-              }}
+              }},
 #endif
-    {}
+        sctx_{ palloc.sctx },
+        flags_{ flag_worker_context } {
+    }
+
+    // worker fiber context owned by a fiber_pool
+    template< typename StackAlloc >
+    context( pooled_context_t,
+             boost::context::preallocated palloc, StackAlloc salloc,
+             detail::context_pool * pool) :
+        use_count_{ 0 },
+        ctx_{ std::allocator_arg, palloc, salloc,
+              [this] (void * vp) noexcept {
+                    run_pooled_( static_cast< data_t * >( vp) );
+              }},
+        pool_{ pool },
+        sctx_{ palloc.sctx },
+        flags_{ flag_worker_context } {
+    }
 
     context( context const&) = delete;
     context & operator=( context const&) = delete;
@@ -350,6 +412,8 @@ public:
 
     void set_ready( context *) noexcept;
 
+    void handoff( context *) noexcept;
+
     bool is_main_context() const noexcept {
         return 0 != ( flags_ & flag_main_context);
     }
@@ -378,10 +442,40 @@ public:
 
     void request_interruption( bool req) noexcept;
 
-    void * get_fss_data( void const * vp) const;
+    // used by ready-queues which are not able to unlink
+    // arbitrary elements (e.g. lock-free work-stealing queue)
+    // returns false if the context is already queued
+    bool queued_mark() noexcept;
+
+    void queued_unmark() noexcept;
+
+    bool is_queued() const noexcept {
+        return 0 != ( flags_ & flag_queued);
+    }
+
+    // set while the fiber holds a spinlock which a fiber resumed
+    // by handoff() might acquire (e.g. condition_variable::wait())
+    bool handoff_blocked() const noexcept {
+        return 0 != ( flags_ & flag_handoff_blocked);
+    }
+
+    void handoff_blocked( bool blck) noexcept;
+
+    // a slot belongs to the fiber_specific_ptr owning cleanup_fn, slots
+    // left over by a destroyed fiber_specific_ptr are detected if its
+    // key has been reused
+    void * get_fss_data( std::size_t key,
+                         detail::fss_cleanup_function const* cleanup_fn) const noexcept {
+        fss_data const* slot = BOOST_FIBERS_FSS_INLINE_SLOTS > key
+            ? & fss_inline_[key]
+            : ( key - BOOST_FIBERS_FSS_INLINE_SLOTS < fss_data_.size()
+                ? & fss_data_[key - BOOST_FIBERS_FSS_INLINE_SLOTS]
+                : nullptr);
+        return nullptr != slot && slot->cleanup_function.get() == cleanup_fn ? slot->vp : nullptr;
+    }
 
     void set_fss_data(
-        void const * vp,
+        std::size_t key,
         detail::fss_cleanup_function::ptr_t const& cleanup_fn,
         void * data,
         bool cleanup_existing);
@@ -392,6 +486,28 @@ public:
         return properties_;
     }
 
+    // size of the properties of the scheduling algorithm used by the
+    // running thread, reserved on the stack of new worker context'
+    static std::size_t active_properties_size() noexcept;
+
+    void set_properties_storage( void * storage, std::size_t size) noexcept {
+        properties_storage_ = storage;
+        properties_storage_size_ = size;
+    }
+
+    void * get_properties_storage( std::size_t size, std::size_t alignment) const noexcept;
+
+    // size of the stack, 0 for the main context
+    std::size_t stack_size() const noexcept {
+        return sctx_.size;
+    }
+
+    // bytes from the top of the stack down to the deepest page ever
+    // touched (sampled with mincore(), pages are assumed to stay resident)
+    // includes the control structures placed on top of the stack
+    // returns 0 if the stack is unknown or not supported by the platform
+    std::size_t stack_high_watermark() const noexcept;
+
     bool ready_is_linked() const noexcept;
 
     bool remote_ready_is_linked() const noexcept;
@@ -410,10 +526,10 @@ public:
         lst.push_back( * this);
     }
 
-    template< typename List >
-    void remote_ready_link( List & lst) noexcept {
-        static_assert( std::is_same< typename List::value_traits::hook_type, detail::remote_ready_hook >::value, "not a remote ready-queue");
-        lst.push_back( * this);
+    template< typename Queue >
+    bool remote_ready_link( Queue & q) noexcept {
+        static_assert( std::is_same< typename Queue::hook_type, detail::remote_ready_hook >::value, "not a remote ready-queue");
+        return q.push( * this);
     }
 
     template< typename Set >
@@ -442,8 +558,6 @@ public:
 
     void ready_unlink() noexcept;
 
-    void remote_ready_unlink() noexcept;
-
     void sleep_unlink() noexcept;
 
     void wait_unlink() noexcept;
@@ -462,7 +576,11 @@ public:
     friend void intrusive_ptr_release( context * ctx) noexcept {
         BOOST_ASSERT( nullptr != ctx);
         if ( 0 == --ctx->use_count_) {
-            ctx->~context();
+            if ( BOOST_LIKELY( nullptr == ctx->pool_) ) {
+                ctx->~context();
+            } else {
+                ctx->release_();
+            }
         }
     }
 };
@@ -480,30 +598,37 @@ struct context_initializer {
 template< typename StackAlloc, typename Fn, typename ... Args >
 static intrusive_ptr< context > make_worker_context( StackAlloc salloc, Fn && fn, Args && ... args) {
     boost::context::stack_context sctx = salloc.allocate();
+    // properties of the scheduling algorithm are placed above the context
+    const std::size_t props_size = context::active_properties_size();
 #if defined(BOOST_NO_CXX14_CONSTEXPR) || defined(BOOST_NO_CXX11_STD_ALIGN)
-    // reserve space for control structure
-    const std::size_t size = sctx.size - sizeof( context);
-    void * sp = static_cast< char * >( sctx.sp) - sizeof( context);
+    // reserve space for control structure, align sp pointer by hand
+    void * sp = reinterpret_cast< void * >(
+            ( reinterpret_cast< std::uintptr_t >( sctx.sp) - sizeof( context) - props_size) &
+            ~ static_cast< std::uintptr_t >( alignof( context) - 1) );
+    const std::size_t size = sctx.size - ( static_cast< char * >( sctx.sp) - static_cast< char * >( sp) );
 #else
-    constexpr std::size_t func_alignment = 64; // alignof( context);
+    constexpr std::size_t func_alignment = alignof( context);
     constexpr std::size_t func_size = sizeof( context);
     // reserve space on stack
-    void * sp = static_cast< char * >( sctx.sp) - func_size - func_alignment;
+    void * sp = static_cast< char * >( sctx.sp) - func_size - props_size - func_alignment;
     // align sp pointer
-    std::size_t space = func_size + func_alignment;
-    sp = std::align( func_alignment, func_size, sp, space);
+    std::size_t space = func_size + props_size + func_alignment;
+    sp = std::align( func_alignment, func_size + props_size, sp, space);
     BOOST_ASSERT( nullptr != sp);
     // calculate remaining size
     const std::size_t size = sctx.size - ( static_cast< char * >( sctx.sp) - static_cast< char * >( sp) );
 #endif
     // placement new of context on top of fiber's stack
-    return intrusive_ptr< context >( 
-            ::new ( sp) context(
+    context * ctx = ::new ( sp) context(
                 worker_context,
                 boost::context::preallocated( sp, size, sctx),
                 salloc,
                 std::forward< Fn >( fn),
-                std::make_tuple( std::forward< Args >( args) ... ) ) );
+                std::make_tuple( std::forward< Args >( args) ... ) );
+    if ( 0 < props_size) {
+        ctx->set_properties_storage( static_cast< char * >( sp) + sizeof( context), props_size);
+    }
+    return intrusive_ptr< context >( ctx);
 }
 
 namespace detail {
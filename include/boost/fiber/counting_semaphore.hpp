@@ -0,0 +1,85 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_COUNTING_SEMAPHORE_H
+#define BOOST_FIBERS_COUNTING_SEMAPHORE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/convert.hpp>
+#include <boost/fiber/detail/spinlock.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+// the permits are kept in an atomic counter: acquiring an available
+// permit and releasing permits while no fiber waits do not touch the
+// spinlock
+// a fiber blocked in acquire() is woken by release() together with the
+// permit (the counter is not incremented for it)
+class BOOST_FIBERS_DECL counting_semaphore {
+private:
+    typedef context::wait_queue_t   wait_queue_t;
+
+    std::atomic< std::ptrdiff_t >   count_;
+    // number of fibers that are (or are about to be) queued
+    std::atomic< std::size_t >      waiters_{ 0 };
+    wait_queue_t                    wait_queue_{};
+    detail::spinlock                wait_queue_splk_{};
+
+    bool try_acquire_until_( std::chrono::steady_clock::time_point const& timeout_time) noexcept;
+
+public:
+    explicit counting_semaphore( std::ptrdiff_t);
+
+    ~counting_semaphore() {
+        BOOST_ASSERT( wait_queue_.empty() );
+    }
+
+    counting_semaphore( counting_semaphore const&) = delete;
+    counting_semaphore & operator=( counting_semaphore const&) = delete;
+
+    static constexpr std::ptrdiff_t max() noexcept {
+        return (std::numeric_limits< std::ptrdiff_t >::max)();
+    }
+
+    // wakes at most update waiting fibers
+    void release( std::ptrdiff_t update = 1);
+
+    void acquire() noexcept;
+
+    bool try_acquire() noexcept;
+
+    template< typename Clock, typename Duration >
+    bool try_acquire_until( std::chrono::time_point< Clock, Duration > const& timeout_time_) noexcept {
+        std::chrono::steady_clock::time_point timeout_time(
+                detail::convert( timeout_time_) );
+        return try_acquire_until_( timeout_time);
+    }
+
+    template< typename Rep, typename Period >
+    bool try_acquire_for( std::chrono::duration< Rep, Period > const& timeout_duration) noexcept {
+        return try_acquire_until_( std::chrono::steady_clock::now() + timeout_duration);
+    }
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_COUNTING_SEMAPHORE_H
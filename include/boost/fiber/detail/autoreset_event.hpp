@@ -1,4 +1,3 @@
-
 //          Copyright Oliver Kowalke 2013.
 // Distributed under the Boost Software License, Version 1.0.
 //    (See accompanying file LICENSE_1_0.txt or copy at
@@ -7,14 +6,23 @@
 #ifndef BOOST_FIBERS_DETAIL_AUTORESET_EVENT_H
 #define BOOST_FIBERS_DETAIL_AUTORESET_EVENT_H
 
-#include <condition_variable>
+#include <atomic>
 #include <chrono>
-#include <mutex>
 
+#include <boost/assert.hpp>
 #include <boost/config.hpp>
 
 #include <boost/fiber/detail/config.hpp>
 
+#if defined(BOOST_FIBERS_HAS_FUTEX)
+# include <cerrno>
+# include <ctime>
+# include <boost/fiber/detail/futex.hpp>
+#else
+# include <condition_variable>
+# include <mutex>
+#endif
+
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
 #endif
@@ -23,11 +31,61 @@ namespace boost {
 namespace fibers {
 namespace detail {
 
+// event waited on by a single thread (the scheduler going idle),
+// set by any thread
+// set() does not enter the kernel unless the waiting thread is parked:
+// if the event is already signaled it is a single atomic load, otherwise
+// a single atomic exchange
 class autoreset_event {
 private:
-    std::mutex              mtx_{};
-    std::condition_variable cnd_{};
-    bool                    flag_{ false };
+    enum {
+        running = 0,
+        signaled,
+        sleeping
+    };
+
+    std::atomic< int >          state_{ running };
+#if ! defined(BOOST_FIBERS_HAS_FUTEX)
+    std::mutex                  mtx_{};
+    std::condition_variable     cnd_{};
+#endif
+
+    void wake_() noexcept {
+#if defined(BOOST_FIBERS_HAS_FUTEX)
+        futex_wake( & state_);
+#else
+        // the waiter tests state_ while holding mtx_
+        std::unique_lock< std::mutex > lk( mtx_);
+        lk.unlock();
+        cnd_.notify_one();
+#endif
+    }
+
+    // returns false if the deadline has been reached
+    bool park_( std::chrono::steady_clock::time_point const& time_point) noexcept {
+#if defined(BOOST_FIBERS_HAS_FUTEX)
+        if ( (std::chrono::steady_clock::time_point::max)() == time_point) {
+            futex_wait( & state_, sleeping);
+            return true;
+        }
+        std::chrono::steady_clock::duration d = time_point - std::chrono::steady_clock::now();
+        if ( d <= std::chrono::steady_clock::duration::zero() ) {
+            return false;
+        }
+        std::chrono::seconds s = std::chrono::duration_cast< std::chrono::seconds >( d);
+        ::timespec ts;
+        ts.tv_sec = static_cast< std::time_t >( s.count() );
+        ts.tv_nsec = static_cast< long >( std::chrono::duration_cast< std::chrono::nanoseconds >( d - s).count() );
+        return ! ( 0 != futex_wait( & state_, sleeping, & ts) && ETIMEDOUT == errno);
+#else
+        std::unique_lock< std::mutex > lk( mtx_);
+        if ( (std::chrono::steady_clock::time_point::max)() == time_point) {
+            cnd_.wait( lk, [this](){ return sleeping != state_.load(); });
+            return true;
+        }
+        return cnd_.wait_until( lk, time_point, [this](){ return sleeping != state_.load(); });
+#endif
+    }
 
 public:
     autoreset_event() noexcept = default;
@@ -35,23 +93,28 @@ public:
     autoreset_event( autoreset_event const&) = delete;
     autoreset_event & operator=( autoreset_event const&) = delete;
 
-    void set() {
-        std::unique_lock< std::mutex > lk( mtx_);
-        flag_ = true;
-        lk.unlock();
-        cnd_.notify_all();
+    void set() noexcept {
+        if ( signaled == state_.load( std::memory_order_acquire) ) {
+            return;
+        }
+        if ( sleeping == state_.exchange( signaled, std::memory_order_acq_rel) ) {
+            wake_();
+        }
     }
 
-    void reset( std::chrono::steady_clock::time_point const& time_point) {
-        if ( (std::chrono::steady_clock::time_point::max)() == time_point) {
-            std::unique_lock< std::mutex > lk( mtx_);
-            cnd_.wait( lk, [&](){ return flag_; });
-            flag_ = false;
-        } else {
-            std::unique_lock< std::mutex > lk( mtx_);
-            cnd_.wait_until( lk, time_point, [&](){ return flag_; });
-            flag_ = false;
+    void reset( std::chrono::steady_clock::time_point const& time_point) noexcept {
+        int expected = running;
+        if ( ! state_.compare_exchange_strong( expected, sleeping, std::memory_order_acq_rel) ) {
+            // already signaled, consume the signal
+            BOOST_ASSERT( signaled == expected);
+            state_.store( running, std::memory_order_release);
+            return;
+        }
+        // spurious wake-ups re-enter park_()
+        while ( sleeping == state_.load( std::memory_order_acquire) && park_( time_point) ) {
         }
+        // consumes a signal set concurrently with a timeout
+        state_.exchange( running, std::memory_order_acq_rel);
     }
 };
 
@@ -0,0 +1,174 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_DETAIL_CLOCK_H
+#define BOOST_FIBERS_DETAIL_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+
+#if defined(__linux__)
+# include <time.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+// interval (nanoseconds) after which tsc_clock re-synchronizes
+// with std::chrono::steady_clock
+#if ! defined(BOOST_FIBERS_TSC_SYNC_INTERVAL)
+# define BOOST_FIBERS_TSC_SYNC_INTERVAL 1000000
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// clocks used by the scheduler to expire deadlines
+// all return time points of std::chrono::steady_clock, deadlines
+// passed by the user are compared without conversion
+// an instance is owned by each scheduler (not shared between threads)
+// idled() is called after the scheduler returned from
+// sched_algorithm::suspend_until()
+
+class steady_clock {
+public:
+    typedef std::chrono::steady_clock::time_point   time_point;
+
+    time_point now() noexcept {
+        return std::chrono::steady_clock::now();
+    }
+
+    void idled() noexcept {
+    }
+};
+
+#if defined(__linux__)
+// CLOCK_MONOTONIC_COARSE: same epoch as CLOCK_MONOTONIC (used by
+// std::chrono::steady_clock), updated once per kernel tick
+// while fibers are running, deadlines expire up to one tick (1-10ms) late
+// the first read after an idle wait uses std::chrono::steady_clock: the
+// scheduler sleeps till the exact deadline, the coarse time would still
+// be behind it and the dispatcher would spin till the next tick
+class coarse_clock {
+public:
+    typedef std::chrono::steady_clock::time_point   time_point;
+
+private:
+    bool    precise_{ false };
+
+public:
+    time_point now() noexcept {
+        if ( BOOST_UNLIKELY( precise_) ) {
+            precise_ = false;
+            return std::chrono::steady_clock::now();
+        }
+        timespec ts;
+        ::clock_gettime( CLOCK_MONOTONIC_COARSE, & ts);
+        return time_point{ std::chrono::duration_cast< time_point::duration >(
+                    std::chrono::seconds{ ts.tv_sec } + std::chrono::nanoseconds{ ts.tv_nsec }) };
+    }
+
+    void idled() noexcept {
+        precise_ = true;
+    }
+};
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+// reads the time stamp counter (requires an invariant TSC)
+// the counter is mapped to std::chrono::steady_clock by an anchor which
+// is renewed every BOOST_FIBERS_TSC_SYNC_INTERVAL, the tick rate is
+// estimated from the time elapsed since construction (during the first
+// interval std::chrono::steady_clock is read)
+class tsc_clock {
+private:
+    typedef std::chrono::steady_clock::duration     duration;
+
+public:
+    typedef std::chrono::steady_clock::time_point   time_point;
+
+private:
+    std::uint64_t   tsc_first_;
+    time_point      tp_first_;
+    std::uint64_t   tsc_anchor_;
+    time_point      tp_anchor_;
+    std::uint64_t   tsc_sync_;
+    // nanoseconds per tick
+    double          ns_per_tick_{ 0 };
+    // time points must not go backwards if the anchor is renewed
+    time_point      last_{};
+
+    void sync_() noexcept {
+        tp_anchor_ = std::chrono::steady_clock::now();
+        tsc_anchor_ = __rdtsc();
+        if ( std::chrono::nanoseconds{ BOOST_FIBERS_TSC_SYNC_INTERVAL } <= tp_anchor_ - tp_first_) {
+            ns_per_tick_ = static_cast< double >(
+                    std::chrono::duration_cast< std::chrono::nanoseconds >( tp_anchor_ - tp_first_).count() ) /
+                static_cast< double >( tsc_anchor_ - tsc_first_);
+            tsc_sync_ = tsc_anchor_ + static_cast< std::uint64_t >( BOOST_FIBERS_TSC_SYNC_INTERVAL / ns_per_tick_);
+        } else {
+            // the rate is not yet known precisely enough,
+            // read std::chrono::steady_clock at the next call
+            tsc_sync_ = tsc_anchor_;
+        }
+    }
+
+public:
+    tsc_clock() noexcept :
+        tsc_first_{ __rdtsc() },
+        tp_first_{ std::chrono::steady_clock::now() },
+        tsc_anchor_{ tsc_first_ },
+        tp_anchor_{ tp_first_ },
+        tsc_sync_{ tsc_first_ } {
+    }
+
+    time_point now() noexcept {
+        std::uint64_t tsc = __rdtsc();
+        if ( BOOST_UNLIKELY( tsc_sync_ <= tsc) ) {
+            sync_();
+            tsc = tsc_anchor_;
+        } else if ( BOOST_UNLIKELY( tsc < tsc_anchor_) ) {
+            // read on a core whose counter lags behind the core
+            // the anchor was taken on, the unsigned difference
+            // would wrap around
+            tsc = tsc_anchor_;
+        }
+        time_point tp = tp_anchor_ + std::chrono::duration_cast< duration >(
+                std::chrono::duration< double, std::nano >{ ( tsc - tsc_anchor_) * ns_per_tick_ });
+        if ( tp < last_) {
+            return last_;
+        }
+        return last_ = tp;
+    }
+
+    void idled() noexcept {
+    }
+};
+#endif
+
+#if defined(BOOST_FIBERS_CLOCK_TSC) && ( defined(__x86_64__) || defined(__i386__) )
+typedef tsc_clock       clock;
+#elif defined(BOOST_FIBERS_CLOCK_COARSE) && defined(__linux__)
+typedef coarse_clock    clock;
+#else
+typedef steady_clock    clock;
+#endif
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_CLOCK_H
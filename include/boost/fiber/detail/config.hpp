@@ -35,4 +35,31 @@
 # include <boost/config/auto_link.hpp>
 #endif
 
+// size of a cache line, members written by different threads
+// are placed on separate cache lines
+#if ! defined(BOOST_FIBERS_CACHELINE_LENGTH)
+# define BOOST_FIBERS_CACHELINE_LENGTH 64
+#endif
+
+// number of busy-wait iterations (with exponential backoff)
+// before a spinlock yields the time slice of the thread
+#if ! defined(BOOST_FIBERS_SPIN_MAX_TESTS)
+# define BOOST_FIBERS_SPIN_MAX_TESTS 64
+#endif
+
+// upper bound of the backoff (CPU pause instructions per iteration)
+#if ! defined(BOOST_FIBERS_SPIN_MAX_BACKOFF)
+# define BOOST_FIBERS_SPIN_MAX_BACKOFF 256
+#endif
+
+// upper bound of the spin iterations of an adaptive mutex
+// waiting for an owner running in another thread
+#if ! defined(BOOST_FIBERS_MUTEX_MAX_SPINS)
+# define BOOST_FIBERS_MUTEX_MAX_SPINS 100
+#endif
+
+#if defined(__linux__) && ! defined(BOOST_FIBERS_NO_FUTEX)
+# define BOOST_FIBERS_HAS_FUTEX
+#endif
+
 #endif // BOOST_FIBERS_DETAIL_CONFIG_H
@@ -0,0 +1,166 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+//  based on Chase & Lev, "Dynamic Circular Work-Stealing Deque" and
+//  Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models"
+
+#ifndef BOOST_FIBERS_DETAIL_CONTEXT_SPMC_QUEUE_H
+#define BOOST_FIBERS_DETAIL_CONTEXT_SPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+class context;
+
+namespace detail {
+
+// single-producer/multi-consumer queue of context'
+// the owner pushes at the bottom, the owner and other threads
+// take from the top (FIFO): fibers yielding to each other must
+// not starve the other ready fibers of the owner
+class context_spmc_queue {
+private:
+    class array {
+    private:
+        typedef std::atomic< context * >    slot_t;
+
+        std::int64_t                size_;
+        std::unique_ptr< slot_t[] > slots_;
+
+    public:
+        explicit array( std::int64_t size) :
+            size_{ size },
+            slots_{ new slot_t[size] } {
+        }
+
+        std::int64_t size() const noexcept {
+            return size_;
+        }
+
+        void push( std::int64_t bottom, context * ctx) noexcept {
+            slots_[bottom & ( size_ - 1)].store( ctx, std::memory_order_relaxed);
+        }
+
+        context * pop( std::int64_t top) noexcept {
+            return slots_[top & ( size_ - 1)].load( std::memory_order_relaxed);
+        }
+
+        array * resize( std::int64_t bottom, std::int64_t top) {
+            array * tmp = new array{ 2 * size_ };
+            for ( std::int64_t i = top; i != bottom; ++i) {
+                tmp->push( i, pop( i) );
+            }
+            return tmp;
+        }
+    };
+
+    std::atomic< std::int64_t >         top_{ 0 };
+    std::atomic< std::int64_t >         bottom_{ 0 };
+    std::atomic< array * >              array_;
+    // arrays replaced by resize() might still be read by
+    // concurrent thieves; keep them until destruction
+    std::vector< std::unique_ptr< array > > old_arrays_{};
+
+public:
+    explicit context_spmc_queue( std::int64_t capacity = 1024) :
+        array_{ new array{ capacity } } {
+        BOOST_ASSERT( 0 < capacity);
+        BOOST_ASSERT( 0 == ( capacity & ( capacity - 1) ) );
+    }
+
+    ~context_spmc_queue() {
+        delete array_.load( std::memory_order_relaxed);
+    }
+
+    context_spmc_queue( context_spmc_queue const&) = delete;
+    context_spmc_queue & operator=( context_spmc_queue const&) = delete;
+
+    bool empty() const noexcept {
+        std::int64_t bottom = bottom_.load( std::memory_order_relaxed);
+        std::int64_t top = top_.load( std::memory_order_relaxed);
+        return bottom <= top;
+    }
+
+    // owner only
+    void push( context * ctx) {
+        std::int64_t bottom = bottom_.load( std::memory_order_relaxed);
+        std::int64_t top = top_.load( std::memory_order_acquire);
+        array * a = array_.load( std::memory_order_relaxed);
+        if ( ( a->size() - 1) < ( bottom - top) ) {
+            // queue is full, grow the array
+            array * tmp = a->resize( bottom, top);
+            old_arrays_.emplace_back( a);
+            a = tmp;
+            array_.store( a, std::memory_order_release);
+        }
+        a->push( bottom, ctx);
+        std::atomic_thread_fence( std::memory_order_release);
+        bottom_.store( bottom + 1, std::memory_order_relaxed);
+    }
+
+    // owner only
+    // takes from the top like steal(), but retries if it
+    // lost the race against a thief
+    context * pop() noexcept {
+        for (;;) {
+            std::int64_t top = top_.load( std::memory_order_relaxed);
+            // pushed by this thread
+            std::int64_t bottom = bottom_.load( std::memory_order_relaxed);
+            if ( bottom <= top) {
+                // queue is empty
+                return nullptr;
+            }
+            context * ctx = array_.load( std::memory_order_relaxed)->pop( top);
+            if ( top_.compare_exchange_weak( top, top + 1,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_relaxed) ) {
+                return ctx;
+            }
+        }
+    }
+
+    // any thread
+    context * steal() noexcept {
+        std::int64_t top = top_.load( std::memory_order_acquire);
+        std::atomic_thread_fence( std::memory_order_seq_cst);
+        std::int64_t bottom = bottom_.load( std::memory_order_acquire);
+        context * ctx = nullptr;
+        if ( top < bottom) {
+            // queue is not empty
+            array * a = array_.load( std::memory_order_consume);
+            ctx = a->pop( top);
+            if ( ! top_.compare_exchange_strong( top, top + 1,
+                                                 std::memory_order_seq_cst,
+                                                 std::memory_order_relaxed) ) {
+                // lost the race against the owner or another thief
+                return nullptr;
+            }
+        }
+        return ctx;
+    }
+};
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_CONTEXT_SPMC_QUEUE_H
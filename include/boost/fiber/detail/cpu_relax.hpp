@@ -0,0 +1,47 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_DETAIL_CPU_RELAX_H
+#define BOOST_FIBERS_DETAIL_CPU_RELAX_H
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+
+#if defined(BOOST_MSVC) && ( defined(_M_IX86) || defined(_M_X64) )
+# include <intrin.h>
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// hint to the CPU that the caller is spinning: saves power, frees
+// resources for the sibling hyper-thread and avoids the memory-order
+// violation (pipeline flush) when the spin loop exits
+inline
+void cpu_relax() noexcept {
+#if defined(BOOST_MSVC) && ( defined(_M_IX86) || defined(_M_X64) )
+    ::_mm_pause();
+#elif defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+    __asm__ __volatile__ ("pause" ::: "memory");
+#elif defined(__GNUC__) && ( defined(__aarch64__) || defined(__arm__) && defined(__ARM_ARCH) && 7 <= __ARM_ARCH )
+    __asm__ __volatile__ ("yield" ::: "memory");
+#elif defined(__GNUC__) && defined(__powerpc__)
+    __asm__ __volatile__ ("or 27,27,27" ::: "memory");
+#endif
+}
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_CPU_RELAX_H
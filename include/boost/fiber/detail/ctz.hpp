@@ -0,0 +1,47 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_DETAIL_CTZ_H
+#define BOOST_FIBERS_DETAIL_CTZ_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// index of the lowest set bit
+inline
+std::size_t ctz( std::uint64_t x) noexcept {
+    BOOST_ASSERT( 0 != x);
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast< std::size_t >( __builtin_ctzll( x) );
+#else
+    std::size_t n = 0;
+    while ( 0 == ( x & 1) ) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_CTZ_H
@@ -15,10 +15,18 @@
 #include <boost/config.hpp>
 #include <boost/intrusive_ptr.hpp>
 
+#include <boost/fiber/detail/config.hpp>
+
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
 #endif
 
+// number of fiber-specific slots stored inside a context,
+// contexts allocate further slots on the heap
+#if ! defined(BOOST_FIBERS_FSS_INLINE_SLOTS)
+# define BOOST_FIBERS_FSS_INLINE_SLOTS 4
+#endif
+
 namespace boost {
 namespace fibers {
 namespace detail {
@@ -49,6 +57,11 @@ public:
     }
 };
 
+// dense slot indices of fiber_specific_ptr, indices of destroyed
+// instances are reused
+BOOST_FIBERS_DECL std::size_t fss_key_create();
+BOOST_FIBERS_DECL void fss_key_delete( std::size_t) noexcept;
+
 }}}
 
 #ifdef BOOST_HAS_ABI_HEADERS
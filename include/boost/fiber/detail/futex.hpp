@@ -0,0 +1,53 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_DETAIL_FUTEX_H
+#define BOOST_FIBERS_DETAIL_FUTEX_H
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+
+#if ! defined(BOOST_FIBERS_HAS_FUTEX)
+# error "futex not supported on this platform"
+#endif
+
+#include <atomic>
+#include <ctime>
+
+extern "C" {
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// blocks if the value at addr equals value; returns on futex_wake(),
+// after timeout (relative, nullptr waits forever) or spuriously
+inline
+int futex_wait( std::atomic< int > * addr, int value, ::timespec const* timeout = nullptr) noexcept {
+    return ::syscall( SYS_futex, reinterpret_cast< int * >( addr), FUTEX_WAIT_PRIVATE, value, timeout, nullptr, 0);
+}
+
+// wakes up at most n threads blocked in futex_wait() on addr
+inline
+int futex_wake( std::atomic< int > * addr, int n = 1) noexcept {
+    return ::syscall( SYS_futex, reinterpret_cast< int * >( addr), FUTEX_WAKE_PRIVATE, n, nullptr, nullptr, 0);
+}
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_FUTEX_H
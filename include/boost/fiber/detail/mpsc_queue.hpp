@@ -0,0 +1,112 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+//  intrusive multi-producer/single-consumer queue
+//  producers push with a CAS on the head (LIFO), the consumer
+//  detaches all elements with one atomic exchange and restores FIFO order
+
+#ifndef BOOST_FIBERS_DETAIL_MPSC_QUEUE_H
+#define BOOST_FIBERS_DETAIL_MPSC_QUEUE_H
+
+#include <atomic>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+template< typename T >
+struct mpsc_hook {
+    // written by the producer before the element is published
+    // read by the consumer after the element was detached
+    T                   *   next{ nullptr };
+    std::atomic< bool >     linked{ false };
+
+    constexpr mpsc_hook() noexcept = default;
+
+    mpsc_hook( mpsc_hook const&) = delete;
+    mpsc_hook & operator=( mpsc_hook const&) = delete;
+
+    bool is_linked() const noexcept {
+        return linked.load( std::memory_order_relaxed);
+    }
+};
+
+template< typename T, mpsc_hook< T > T::* Hook >
+class mpsc_queue {
+private:
+    std::atomic< T * >  head_{ nullptr };
+
+public:
+    typedef mpsc_hook< T >  hook_type;
+
+    mpsc_queue() noexcept = default;
+
+    mpsc_queue( mpsc_queue const&) = delete;
+    mpsc_queue & operator=( mpsc_queue const&) = delete;
+
+    bool empty() const noexcept {
+        return nullptr == head_.load( std::memory_order_relaxed);
+    }
+
+    // returns false if the element is already enqueued
+    bool push( T & t) noexcept {
+        hook_type & hook = t.*Hook;
+        if ( hook.linked.exchange( true, std::memory_order_relaxed) ) {
+            // a pending wakeup has not been consumed yet
+            return false;
+        }
+        T * head = head_.load( std::memory_order_relaxed);
+        do {
+            hook.next = head;
+        } while ( ! head_.compare_exchange_weak( head, & t,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed) );
+        return true;
+    }
+
+    // detaches all elements and passes them in FIFO order to fn
+    template< typename Fn >
+    void consume_all( Fn && fn) noexcept {
+        // do not write the shared cache line if nothing was pushed
+        if ( nullptr == head_.load( std::memory_order_relaxed) ) {
+            return;
+        }
+        T * head = head_.exchange( nullptr, std::memory_order_acquire);
+        // reverse LIFO order
+        T * fifo = nullptr;
+        while ( nullptr != head) {
+            T * next = ( head->*Hook).next;
+            ( head->*Hook).next = fifo;
+            fifo = head;
+            head = next;
+        }
+        while ( nullptr != fifo) {
+            T * t = fifo;
+            fifo = ( t->*Hook).next;
+            ( t->*Hook).next = nullptr;
+            // unlink before t is handed out; t might be
+            // resumed (and destroyed) by another thread afterwards
+            ( t->*Hook).linked.store( false, std::memory_order_release);
+            fn( t);
+        }
+    }
+};
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_MPSC_QUEUE_H
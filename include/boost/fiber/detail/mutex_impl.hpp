@@ -0,0 +1,111 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_DETAIL_MUTEX_IMPL_H
+#define BOOST_FIBERS_DETAIL_MUTEX_IMPL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/spinlock.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// state shared by the fiber mutexes: an atomic word holding the owning
+// context, bit 0 is set while fibers are (or are about to be) queued
+// uncontended lock and unlock are a single CAS each, the spinlock
+// guarding the wait-queue is taken only if the bit is set
+// an owner can not release the mutex without the spinlock while
+// the bit is set
+class BOOST_FIBERS_DECL mutex_impl {
+private:
+    typedef context::wait_queue_t   wait_queue_t;
+
+    static constexpr std::uintptr_t waiters_bit = 1;
+
+    std::atomic< std::uintptr_t >   state_{ 0 };
+    wait_queue_t                    wait_queue_{};
+    spinlock                        wait_queue_splk_{};
+    // adaptive mode: spin while the owner runs in another thread
+    bool                            adaptive_{ false };
+    // moving average of the spin iterations recent calls of lock_slow()
+    // have waited for the owner (updated without synchronization)
+    std::atomic< int >              spins_{ 0 };
+
+    static std::uintptr_t bits_( context * ctx) noexcept {
+        BOOST_ASSERT( 0 == ( reinterpret_cast< std::uintptr_t >( ctx) & waiters_bit) );
+        return reinterpret_cast< std::uintptr_t >( ctx);
+    }
+
+    bool spin_( context *, spinlock_lock &) noexcept;
+
+    void unlock_slow_() noexcept;
+
+public:
+    mutex_impl() = default;
+
+    explicit mutex_impl( bool adaptive) noexcept :
+        adaptive_{ adaptive } {
+    }
+
+    ~mutex_impl() {
+        BOOST_ASSERT( 0 == state_.load( std::memory_order_relaxed) );
+        BOOST_ASSERT( wait_queue_.empty() );
+    }
+
+    mutex_impl( mutex_impl const&) = delete;
+    mutex_impl & operator=( mutex_impl const&) = delete;
+
+    // exact for the owner itself, a hint for other fibers
+    context * owner() const noexcept {
+        return reinterpret_cast< context * >(
+            state_.load( std::memory_order_relaxed) & ~waiters_bit);
+    }
+
+    bool try_lock( context * ctx) noexcept {
+        std::uintptr_t expected = 0;
+        return state_.compare_exchange_strong(
+            expected, bits_( ctx), std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    // suspends ctx till the ownership is passed to it
+    // pre-condition: ctx is not the owner
+    void lock_slow( context *) noexcept;
+
+    // returns false if the timeout expired
+    // pre-condition: ctx is not the owner
+    bool try_lock_until( context *, std::chrono::steady_clock::time_point const&) noexcept;
+
+    // passes the ownership to the first waiting fiber (if any)
+    // pre-condition: ctx is the owner
+    void unlock( context * ctx) noexcept {
+        BOOST_ASSERT( ctx == owner() );
+        std::uintptr_t expected = bits_( ctx);
+        if ( ! state_.compare_exchange_strong(
+                    expected, 0, std::memory_order_release, std::memory_order_relaxed) ) {
+            unlock_slow_();
+        }
+    }
+};
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_MUTEX_IMPL_H
@@ -0,0 +1,50 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_DETAIL_NUMA_H
+#define BOOST_FIBERS_DETAIL_NUMA_H
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// NUMA topology as reported by the kernel (Linux: sysfs, read once)
+// other platforms are reported as a single node containing all CPUs
+
+// number of NUMA nodes (at least 1)
+BOOST_FIBERS_DECL std::size_t numa_node_count() noexcept;
+
+// node of a CPU, 0 if unknown
+BOOST_FIBERS_DECL std::size_t numa_node_of_cpu( std::size_t cpu) noexcept;
+
+// node of the CPU the calling thread is running on
+BOOST_FIBERS_DECL std::size_t numa_current_node() noexcept;
+
+// CPUs of a node in ascending order
+BOOST_FIBERS_DECL std::vector< std::size_t > numa_node_cpus( std::size_t node);
+
+// sets the memory policy of the pages of [vp, vp + size) to prefer
+// node, vp must be page aligned; pages already touched are not moved
+// returns false if not supported
+BOOST_FIBERS_DECL bool numa_bind( void * vp, std::size_t size, std::size_t node) noexcept;
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_NUMA_H
@@ -0,0 +1,78 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_DETAIL_POOL_TASK_H
+#define BOOST_FIBERS_DETAIL_POOL_TASK_H
+
+#include <type_traits>
+#include <utility>
+
+#include <boost/config.hpp>
+#include <boost/context/detail/apply.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+// bytes reserved on the stack of a pooled context for the function
+// (and its arguments) passed to fiber_pool::launch(), larger
+// functions are allocated on the heap
+#if ! defined(BOOST_FIBERS_POOL_TASK_SIZE)
+# define BOOST_FIBERS_POOL_TASK_SIZE 128
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// function bound to a pooled context (or posted to a runtime)
+class pool_task {
+public:
+    virtual void run() = 0;
+
+    // destroys the task, releases its memory if allocated on the heap
+    virtual void destroy() noexcept = 0;
+
+protected:
+    ~pool_task() = default;
+};
+
+template< typename Fn, typename Tpl >
+class pool_task_impl final : public pool_task {
+private:
+    Fn      fn_;
+    Tpl     tpl_;
+    bool    heap_;
+
+public:
+    template< typename F, typename T >
+    pool_task_impl( bool heap, F && fn, T && tpl) :
+        fn_( std::forward< F >( fn) ),
+        tpl_( std::forward< T >( tpl) ),
+        heap_{ heap } {
+    }
+
+    void run() override final {
+        boost::context::detail::apply( fn_, tpl_);
+    }
+
+    void destroy() noexcept override final {
+        if ( heap_) {
+            delete this;
+        } else {
+            this->~pool_task_impl();
+        }
+    }
+};
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_POOL_TASK_H
@@ -0,0 +1,106 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_DETAIL_SHARED_MUTEX_IMPL_H
+#define BOOST_FIBERS_DETAIL_SHARED_MUTEX_IMPL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/spinlock.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// state shared by shared_mutex and shared_timed_mutex, guarded by a
+// spinlock
+// readers and writers wait in separate queues; the ownership is passed
+// to the woken fibers (a single writer or all waiting readers at once)
+// new readers are blocked while a writer owns the mutex or is waiting
+// for it, this prevents the starvation of writers
+// on release by a writer, waiting writers are preferred by default,
+// waiting readers if phase-fair (read and write phases alternate)
+class BOOST_FIBERS_DECL shared_mutex_impl {
+private:
+    typedef context::wait_queue_t   wait_queue_t;
+
+    // exclusive owner
+    std::atomic< context * >        writer_{ nullptr };
+    // number of fibers sharing the ownership
+    std::size_t                     readers_{ 0 };
+    wait_queue_t                    readers_queue_{};
+    wait_queue_t                    writers_queue_{};
+    spinlock                        wait_queue_splk_{};
+    bool                            phase_fair_{ false };
+
+    void wake_writer_( spinlock_lock &) noexcept;
+
+    void wake_readers_( spinlock_lock &) noexcept;
+
+public:
+    shared_mutex_impl() = default;
+
+    explicit shared_mutex_impl( bool phase_fair) noexcept :
+        phase_fair_{ phase_fair } {
+    }
+
+    ~shared_mutex_impl() {
+        BOOST_ASSERT( nullptr == writer_.load( std::memory_order_relaxed) );
+        BOOST_ASSERT( 0 == readers_);
+        BOOST_ASSERT( readers_queue_.empty() );
+        BOOST_ASSERT( writers_queue_.empty() );
+    }
+
+    shared_mutex_impl( shared_mutex_impl const&) = delete;
+    shared_mutex_impl & operator=( shared_mutex_impl const&) = delete;
+
+    // exact for the owner itself, a hint for other fibers
+    context * owner() const noexcept {
+        return writer_.load( std::memory_order_relaxed);
+    }
+
+    // pre-condition: ctx is not the owner
+    void lock( context *) noexcept;
+
+    bool try_lock( context *) noexcept;
+
+    // returns false if the timeout expired
+    // pre-condition: ctx is not the owner
+    bool try_lock_until( context *, std::chrono::steady_clock::time_point const&) noexcept;
+
+    // pre-condition: the active fiber is the owner
+    void unlock() noexcept;
+
+    // pre-condition: ctx is not the owner
+    void lock_shared( context *) noexcept;
+
+    bool try_lock_shared() noexcept;
+
+    // returns false if the timeout expired
+    // pre-condition: ctx is not the owner
+    bool try_lock_shared_until( context *, std::chrono::steady_clock::time_point const&) noexcept;
+
+    // returns false if the mutex is not shared
+    bool unlock_shared() noexcept;
+};
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_SHARED_MUTEX_IMPL_H
@@ -1,4 +1,3 @@
-
 //          Copyright Oliver Kowalke 2013.
 // Distributed under the Boost Software License, Version 1.0.
 //    (See accompanying file LICENSE_1_0.txt or copy at
@@ -10,6 +9,7 @@
 #define BOOST_FIBERS_SPINLOCK_H
 
 #include <atomic>
+#include <cstddef>
 #include <mutex>
 
 #include <boost/fiber/detail/config.hpp>
@@ -18,6 +18,8 @@ namespace boost {
 namespace fibers {
 namespace detail {
 
+// test-and-test-and-set lock, spins with exponential backoff
+// and yields after BOOST_FIBERS_SPIN_MAX_TESTS iterations
 class BOOST_FIBERS_DECL atomic_spinlock {
 private:
     enum class spinlock_status {
@@ -37,6 +39,49 @@ public:
     void unlock() noexcept;
 };
 
+// FIFO lock, waiters spin proportional to their distance to the head
+// of the queue; prevents starvation under heavy contention
+class BOOST_FIBERS_DECL ticket_spinlock {
+private:
+    std::atomic< std::size_t >  next_ticket_{ 0 };
+    std::atomic< std::size_t >  now_serving_{ 0 };
+
+public:
+    ticket_spinlock() noexcept = default;
+
+    ticket_spinlock( ticket_spinlock const&) = delete;
+    ticket_spinlock & operator=( ticket_spinlock const&) = delete;
+
+    void lock() noexcept;
+    void unlock() noexcept;
+};
+
+// queue lock (Mellor-Crummey/Scott, K42 variant): each waiter spins on
+// a node on its own stack, the lock is handed over to the successor
+// without a global cache-line transfer
+// the K42 variant keeps the interface of lock()/unlock(), the holder
+// does not own a queue node
+class BOOST_FIBERS_DECL mcs_spinlock {
+private:
+    struct node {
+        std::atomic< node * >   tail{ nullptr };
+        std::atomic< node * >   next{ nullptr };
+    };
+
+    // tail: last waiter, this if locked without waiters
+    // next: first waiter
+    node    q_{};
+
+public:
+    mcs_spinlock() noexcept = default;
+
+    mcs_spinlock( mcs_spinlock const&) = delete;
+    mcs_spinlock & operator=( mcs_spinlock const&) = delete;
+
+    void lock() noexcept;
+    void unlock() noexcept;
+};
+
 struct non_spinlock {
     constexpr non_spinlock() noexcept {}
     void lock() noexcept {}
@@ -49,8 +94,14 @@ struct non_lock {
     void unlock() noexcept {}
 };
 
-#if ! defined(BOOST_FIBES_NO_ATOMICS) 
+#if ! defined(BOOST_FIBES_NO_ATOMICS)
+# if defined(BOOST_FIBERS_SPINLOCK_TICKET)
+typedef ticket_spinlock spinlock;
+# elif defined(BOOST_FIBERS_SPINLOCK_MCS)
+typedef mcs_spinlock    spinlock;
+# else
 typedef atomic_spinlock spinlock;
+# endif
 using spinlock_lock = std::unique_lock< spinlock >;
 #else
 typedef non_spinlock    spinlock;
@@ -0,0 +1,271 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_DETAIL_STACK_POOL_H
+#define BOOST_FIBERS_DETAIL_STACK_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <boost/context/stack_context.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/spinlock.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// stacks released by StackAllocator are cached in a free list per thread;
+// if a thread caches more than high-watermark stacks, all but
+// low-watermark stacks are moved to the global pool (at most
+// max-global stacks, the rest is deallocated)
+// a thread without cached stacks takes low-watermark stacks
+// from the global pool
+// the free lists are linked through the top of the cached stacks,
+// no additional memory is allocated
+template< typename StackAllocator >
+class stack_pool : public std::enable_shared_from_this< stack_pool< StackAllocator > > {
+private:
+    struct node {
+        boost::context::stack_context   sctx;
+        node                        *   next;
+    };
+
+    struct cache {
+        std::shared_ptr< stack_pool >   pool;
+        node                        *   head;
+        std::size_t                     count;
+    };
+
+    // caches of all pools (using StackAllocator) of a thread,
+    // returned to the global pools at thread exit
+    class registry {
+    private:
+        bool                &   destroyed_;
+        std::vector< cache >    caches_{};
+
+    public:
+        explicit registry( bool & destroyed) noexcept :
+            destroyed_( destroyed) {
+        }
+
+        ~registry() {
+            for ( cache & c : caches_) {
+                c.pool->give_( c.head);
+            }
+            destroyed_ = true;
+        }
+
+        registry( registry const&) = delete;
+        registry & operator=( registry const&) = delete;
+
+        cache & get( stack_pool * pool) {
+            for ( cache & c : caches_) {
+                if ( pool == c.pool.get() ) {
+                    return c;
+                }
+            }
+            // release caches of pools not referenced by any allocator
+            for ( std::size_t i = 0; i < caches_.size();) {
+                if ( 1 == caches_[i].pool.use_count() ) {
+                    caches_[i].pool->give_( caches_[i].head);
+                    caches_[i] = std::move( caches_.back() );
+                    caches_.pop_back();
+                } else {
+                    ++i;
+                }
+            }
+            caches_.push_back( cache{ pool->shared_from_this(), nullptr, 0 });
+            return caches_.back();
+        }
+    };
+
+    StackAllocator      salloc_;
+    std::size_t         high_watermark_;
+    std::size_t         low_watermark_;
+    std::size_t         max_global_;
+    detail::spinlock    splk_{};
+    node            *   global_{ nullptr };
+    std::size_t         global_count_{ 0 };
+
+    static registry * registry_() {
+        // stacks might be deallocated by thread-local destructors
+        // running after the registry has been destroyed
+        static thread_local bool destroyed = false;
+        if ( destroyed) {
+            return nullptr;
+        }
+        static thread_local registry r( destroyed);
+        return & r;
+    }
+
+    static node * to_node_( boost::context::stack_context const& sctx) noexcept {
+        // node is stored at the top of the (unused) stack
+        std::uintptr_t p = reinterpret_cast< std::uintptr_t >( sctx.sp) - sizeof( node);
+        p &= ~static_cast< std::uintptr_t >( alignof( node) - 1);
+        return ::new ( reinterpret_cast< void * >( p) ) node{ sctx, nullptr };
+    }
+
+    // removes at most n stacks from the global pool
+    node * take_( std::size_t n, std::size_t & count) noexcept {
+        std::unique_lock< detail::spinlock > lk( splk_);
+        node * head = global_;
+        node * tail = nullptr;
+        for ( count = 0; count < n && nullptr != global_; ++count) {
+            tail = global_;
+            global_ = global_->next;
+        }
+        global_count_ -= count;
+        lk.unlock();
+        if ( nullptr != tail) {
+            tail->next = nullptr;
+            return head;
+        }
+        return nullptr;
+    }
+
+    // returns a list of stacks to the global pool,
+    // stacks exceeding max-global are deallocated
+    void give_( node * head) noexcept {
+        std::unique_lock< detail::spinlock > lk( splk_);
+        while ( nullptr != head && global_count_ < max_global_) {
+            node * nxt = head->next;
+            head->next = global_;
+            global_ = head;
+            ++global_count_;
+            head = nxt;
+        }
+        lk.unlock();
+        while ( nullptr != head) {
+            node * nxt = head->next;
+            boost::context::stack_context sctx = head->sctx;
+            salloc_.deallocate( sctx);
+            head = nxt;
+        }
+    }
+
+public:
+    stack_pool( std::size_t size,
+                std::size_t high_watermark,
+                std::size_t low_watermark,
+                std::size_t max_global) :
+        salloc_( size),
+        high_watermark_( high_watermark),
+        low_watermark_( low_watermark),
+        max_global_( max_global) {
+        BOOST_ASSERT( low_watermark_ <= high_watermark_);
+    }
+
+    ~stack_pool() {
+        while ( nullptr != global_) {
+            node * nxt = global_->next;
+            boost::context::stack_context sctx = global_->sctx;
+            salloc_.deallocate( sctx);
+            global_ = nxt;
+        }
+    }
+
+    stack_pool( stack_pool const&) = delete;
+    stack_pool & operator=( stack_pool const&) = delete;
+
+    boost::context::stack_context allocate() {
+        registry * r = registry_();
+        if ( nullptr != r) {
+            cache & c = r->get( this);
+            if ( nullptr == c.head) {
+                // refill the cache from the global pool
+                c.head = take_( ( std::max)( low_watermark_, std::size_t( 1) ), c.count);
+            }
+            if ( nullptr != c.head) {
+                node * n = c.head;
+                c.head = n->next;
+                --c.count;
+                return n->sctx;
+            }
+        } else {
+            std::size_t count = 0;
+            node * n = take_( 1, count);
+            if ( nullptr != n) {
+                return n->sctx;
+            }
+        }
+        return salloc_.allocate();
+    }
+
+    void deallocate( boost::context::stack_context & sctx) {
+        BOOST_ASSERT( nullptr != sctx.sp);
+        node * n = to_node_( sctx);
+        registry * r = registry_();
+        if ( nullptr == r) {
+            give_( n);
+            return;
+        }
+        cache & c = r->get( this);
+        n->next = c.head;
+        c.head = n;
+        if ( ++c.count <= high_watermark_) {
+            return;
+        }
+        // keep low-watermark stacks, move the rest to the global pool
+        node * tail = c.head;
+        for ( std::size_t i = 1; i < low_watermark_; ++i) {
+            tail = tail->next;
+        }
+        node * excess = c.head;
+        if ( 0 == low_watermark_) {
+            c.head = nullptr;
+        } else {
+            excess = tail->next;
+            tail->next = nullptr;
+        }
+        c.count = low_watermark_;
+        give_( excess);
+    }
+};
+
+template< typename StackAllocator >
+class basic_pooled_stack {
+private:
+    std::shared_ptr< stack_pool< StackAllocator > > pool_;
+
+public:
+    typedef typename StackAllocator::traits_type   traits_type;
+
+    basic_pooled_stack( std::size_t size = traits_type::default_size(),
+                        std::size_t high_watermark = 64,
+                        std::size_t low_watermark = 16,
+                        std::size_t max_global = 1024) :
+        pool_{ std::make_shared< stack_pool< StackAllocator > >(
+                size, high_watermark, low_watermark, max_global) } {
+    }
+
+    boost::context::stack_context allocate() {
+        return pool_->allocate();
+    }
+
+    void deallocate( boost::context::stack_context & sctx) {
+        pool_->deallocate( sctx);
+    }
+};
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_STACK_POOL_H
@@ -0,0 +1,286 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_DETAIL_TIMER_WHEEL_H
+#define BOOST_FIBERS_DETAIL_TIMER_WHEEL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/ctz.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// hierarchical hashed timer wheel (Varghese/Lauck)
+// level 0 has 256 slots of one tick, levels 1-3 have 64 slots each,
+// covering 2^26 ticks; deadlines beyond are kept in an overflow list
+// which is rehashed whenever level 3 wraps around
+// each slot is an intrusive list of auto-unlink hooks: insertion is O(1),
+// cancelation is O(1) by unlinking the hook (the slot is not told about it,
+// the occupancy bitmaps are therefore only a hint and are cleared lazily)
+// List          - intrusive list (auto_unlink member hook) of T
+// TimePointOf   - functor returning the deadline of an element
+// Tick          - resolution of the wheel, a deadline fires at the first tick
+//                 boundary not before the deadline
+template< typename List, typename TimePointOf, typename Tick >
+class timer_wheel {
+public:
+    typedef typename List::value_traits                 value_traits;
+    typedef typename List::value_type                   value_type;
+    typedef std::chrono::steady_clock::time_point       time_point;
+
+private:
+    enum {
+        level0_bits = 8,
+        level0_size = 1 << level0_bits,
+        level_bits = 6,
+        level_size = 1 << level_bits,
+        levels = 3,
+        span_bits = level0_bits + levels * level_bits
+    };
+
+    typedef std::uint64_t   tick_t;
+
+    List            level0_[level0_size];
+    std::uint64_t   level0_mask_[level0_size / 64];
+    List            levels_[levels][level_size];
+    std::uint64_t   levels_mask_[levels];
+    List            overflow_{};
+    // next tick to be processed
+    tick_t          now_;
+
+    static std::uint64_t rotr_( std::uint64_t x, std::size_t n) noexcept {
+        return 0 == n ? x : ( x >> n) | ( x << ( 64 - n) );
+    }
+
+    static tick_t floor_ticks_( time_point const& tp) noexcept {
+        typename Tick::rep t = std::chrono::duration_cast< Tick >( tp.time_since_epoch() ).count();
+        return 0 < t ? static_cast< tick_t >( t) : 0;
+    }
+
+    static tick_t ceil_ticks_( time_point const& tp) noexcept {
+        Tick t = std::chrono::duration_cast< Tick >( tp.time_since_epoch() );
+        if ( t < tp.time_since_epoch() ) {
+            t += Tick{ 1 };
+        }
+        return 0 < t.count() ? static_cast< tick_t >( t.count() ) : 0;
+    }
+
+    static time_point to_time_point_( tick_t t) noexcept {
+        return time_point{ std::chrono::duration_cast< time_point::duration >( Tick{ static_cast< typename Tick::rep >( t) }) };
+    }
+
+    static std::size_t shift_( std::size_t level) noexcept {
+        return level0_bits + level * level_bits;
+    }
+
+    void link_( value_type & v) noexcept {
+        tick_t t = ceil_ticks_( TimePointOf()( v) );
+        if ( t < now_) {
+            // deadline has already passed, fire at next tick
+            t = now_;
+        }
+        tick_t delta = t - now_;
+        if ( delta < level0_size) {
+            std::size_t idx = static_cast< std::size_t >( t & ( level0_size - 1) );
+            level0_[idx].push_back( v);
+            level0_mask_[idx / 64] |= std::uint64_t( 1) << ( idx % 64);
+            return;
+        }
+        for ( std::size_t l = 0; l < levels; ++l) {
+            if ( delta < ( tick_t( 1) << ( shift_( l) + level_bits) ) ) {
+                std::size_t idx = static_cast< std::size_t >( ( t >> shift_( l) ) & ( level_size - 1) );
+                levels_[l][idx].push_back( v);
+                levels_mask_[l] |= std::uint64_t( 1) << idx;
+                return;
+            }
+        }
+        overflow_.push_back( v);
+    }
+
+    void rehash_( List & lst) noexcept {
+        List tmp;
+        tmp.swap( lst);
+        while ( ! tmp.empty() ) {
+            value_type & v = tmp.front();
+            tmp.pop_front();
+            link_( v);
+        }
+    }
+
+    // slots of higher levels are cascaded as soon as now_ enters
+    // a new block of level 0
+    void advance_( tick_t t) noexcept {
+        BOOST_ASSERT( now_ < t);
+        now_ = t;
+        if ( 0 != ( now_ & ( level0_size - 1) ) ) {
+            return;
+        }
+        for ( std::size_t l = 0; l < levels; ++l) {
+            std::size_t idx = static_cast< std::size_t >( ( now_ >> shift_( l) ) & ( level_size - 1) );
+            levels_mask_[l] &= ~( std::uint64_t( 1) << idx);
+            rehash_( levels_[l][idx]);
+            if ( 0 != idx) {
+                return;
+            }
+        }
+        rehash_( overflow_);
+    }
+
+    // first slot of level 0 at index >= from containing elements,
+    // level0_size if none
+    std::size_t next_level0_( std::size_t from) noexcept {
+        for ( std::size_t w = from / 64; w < level0_size / 64; ++w) {
+            std::uint64_t m = level0_mask_[w];
+            if ( w == from / 64) {
+                m &= ~std::uint64_t( 0) << ( from % 64);
+            }
+            while ( 0 != m) {
+                std::size_t idx = w * 64 + detail::ctz( m);
+                if ( ! level0_[idx].empty() ) {
+                    return idx;
+                }
+                // elements have been unlinked
+                level0_mask_[w] &= ~( std::uint64_t( 1) << ( idx % 64) );
+                m &= m - 1;
+            }
+        }
+        return level0_size;
+    }
+
+    // next tick at which a slot of level 0 fires or a slot
+    // of a higher level is cascaded
+    tick_t next_tick_() noexcept {
+        std::size_t idx = static_cast< std::size_t >( now_ & ( level0_size - 1) );
+        tick_t block = now_ - idx;
+        std::size_t next = next_level0_( idx);
+        if ( level0_size != next) {
+            return block + next;
+        }
+        tick_t result = ( std::numeric_limits< tick_t >::max)();
+        // deadlines of level 0 wrapped around into the next block
+        if ( level0_size != next_level0_( 0) ) {
+            result = block + level0_size;
+        }
+        for ( std::size_t l = 0; l < levels; ++l) {
+            std::size_t shift = shift_( l);
+            tick_t cur = now_ >> shift;
+            // search slots cur + 1, cur + 2, ..., cur + level_size
+            std::size_t start = static_cast< std::size_t >( ( cur + 1) & ( level_size - 1) );
+            std::uint64_t m = rotr_( levels_mask_[l], start);
+            while ( 0 != m) {
+                std::size_t k = detail::ctz( m);
+                std::size_t slot = ( start + k) & ( level_size - 1);
+                if ( ! levels_[l][slot].empty() ) {
+                    result = ( std::min)( result, ( cur + 1 + k) << shift);
+                    break;
+                }
+                // elements have been unlinked
+                levels_mask_[l] &= ~( std::uint64_t( 1) << slot);
+                m &= m - 1;
+            }
+        }
+        if ( ! overflow_.empty() ) {
+            result = ( std::min)( result, ( ( now_ >> span_bits) + 1) << span_bits);
+        }
+        return result;
+    }
+
+public:
+    timer_wheel() noexcept :
+        level0_mask_{},
+        levels_mask_{},
+        now_{ floor_ticks_( std::chrono::steady_clock::now() ) } {
+    }
+
+    timer_wheel( timer_wheel const&) = delete;
+    timer_wheel & operator=( timer_wheel const&) = delete;
+
+    bool empty() const noexcept {
+        for ( std::size_t w = 0; w < level0_size / 64; ++w) {
+            for ( std::uint64_t m = level0_mask_[w]; 0 != m; m &= m - 1) {
+                if ( ! level0_[w * 64 + detail::ctz( m)].empty() ) {
+                    return false;
+                }
+            }
+        }
+        for ( std::size_t l = 0; l < levels; ++l) {
+            for ( std::uint64_t m = levels_mask_[l]; 0 != m; m &= m - 1) {
+                if ( ! levels_[l][detail::ctz( m)].empty() ) {
+                    return false;
+                }
+            }
+        }
+        return overflow_.empty();
+    }
+
+    void insert( value_type & v) noexcept {
+        link_( v);
+    }
+
+    // unlinks all elements with a deadline not later than tp
+    // and passes them to fn
+    template< typename Fn >
+    void expire( time_point const& tp, Fn && fn) noexcept {
+        tick_t target = floor_ticks_( tp);
+        while ( now_ <= target) {
+            std::size_t idx = static_cast< std::size_t >( now_ & ( level0_size - 1) );
+            std::size_t next = next_level0_( idx);
+            if ( level0_size == next) {
+                // nothing left in this block, skip empty slots
+                advance_( ( std::min)( next_tick_(), target + 1) );
+                continue;
+            }
+            tick_t t = now_ - idx + next;
+            if ( target < t) {
+                advance_( target + 1);
+                break;
+            }
+            level0_mask_[next / 64] &= ~( std::uint64_t( 1) << ( next % 64) );
+            List tmp;
+            tmp.swap( level0_[next]);
+            // detach the slot first, entering the next block might
+            // cascade elements into it
+            advance_( t + 1);
+            while ( ! tmp.empty() ) {
+                value_type & v = tmp.front();
+                tmp.pop_front();
+                fn( & v);
+            }
+        }
+    }
+
+    // lower bound of the earliest deadline stored in the wheel,
+    // time_point::max() if the wheel is empty
+    // elements of higher levels are reported by the tick they are
+    // cascaded at
+    time_point next_deadline() noexcept {
+        tick_t t = next_tick_();
+        return ( std::numeric_limits< tick_t >::max)() == t
+            ? ( time_point::max)()
+            : to_time_point_( t);
+    }
+};
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_DETAIL_TIMER_WHEEL_H
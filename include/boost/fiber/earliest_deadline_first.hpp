@@ -0,0 +1,155 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_EARLIEST_DEADLINE_FIRST_H
+#define BOOST_FIBERS_EARLIEST_DEADLINE_FIRST_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/algorithm.hpp>
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/autoreset_event.hpp>
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/properties.hpp>
+#include <boost/fiber/scheduler.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+class earliest_deadline_first;
+
+class deadline_props : public fiber_properties {
+public:
+    typedef std::chrono::steady_clock::time_point   time_point;
+
+private:
+    friend class earliest_deadline_first;
+
+    time_point          deadline_{ (time_point::max)() };
+    // links of the pairing heap, prev_ points to the parent
+    // if the fiber is the leftmost child
+    deadline_props  *   child_{ nullptr };
+    deadline_props  *   next_{ nullptr };
+    deadline_props  *   prev_{ nullptr };
+    // orders fibers with equal deadlines FIFO
+    std::uint64_t       seq_{ 0 };
+    bool                heap_linked_{ false };
+
+    void notify_() noexcept;
+
+public:
+    deadline_props( context * ctx) noexcept :
+        fiber_properties( ctx) {
+    }
+
+    time_point get_deadline() const noexcept {
+        return deadline_;
+    }
+
+    bool has_deadline() const noexcept {
+        return (time_point::max)() != deadline_;
+    }
+
+    // absolute deadline, time_point::max() removes the deadline
+    void set_deadline( time_point const& deadline) noexcept {
+        if ( deadline != deadline_) {
+            deadline_ = deadline;
+            notify_();
+        }
+    }
+
+    template< typename Rep, typename Period >
+    void set_deadline( std::chrono::duration< Rep, Period > const& timeout) noexcept {
+        set_deadline( std::chrono::steady_clock::now() + timeout);
+    }
+
+    void clear_deadline() noexcept {
+        set_deadline( (time_point::max)() );
+    }
+};
+
+// ready fibers with a deadline are kept in an intrusive pairing heap
+// ordered by deadline (the links live in deadline_props, no allocation),
+// fibers without deadline are resumed FIFO if no fiber with deadline
+// is ready
+class BOOST_FIBERS_DECL earliest_deadline_first : public sched_algorithm_with_properties< deadline_props > {
+private:
+    typedef scheduler::ready_queue_t    rqueue_t;
+
+    // root of the pairing heap
+    deadline_props          *   heap_{ nullptr };
+    std::uint64_t               seq_{ 0 };
+    // fibers without deadline
+    rqueue_t                    rqueue_{};
+    // the dispatcher-context is kept apart, it must run even
+    // if fibers with deadline keep yielding
+    context                 *   dispatcher_{ nullptr };
+    std::size_t                 ticks_{ 0 };
+    detail::autoreset_event     ev_{};
+
+    static bool less_( deadline_props const* l, deadline_props const* r) noexcept {
+        return l->deadline_ < r->deadline_ ||
+            ( l->deadline_ == r->deadline_ && l->seq_ < r->seq_);
+    }
+
+    static deadline_props * meld_( deadline_props *, deadline_props *) noexcept;
+
+    static deadline_props * merge_pairs_( deadline_props *) noexcept;
+
+    void push_( deadline_props *) noexcept;
+
+    deadline_props * pop_() noexcept;
+
+    void erase_( deadline_props *) noexcept;
+
+public:
+    earliest_deadline_first() = default;
+
+    earliest_deadline_first( earliest_deadline_first const&) = delete;
+    earliest_deadline_first & operator=( earliest_deadline_first const&) = delete;
+
+    virtual void awakened( context *, deadline_props &) noexcept;
+
+    virtual context * pick_next() noexcept;
+
+    virtual bool has_ready_fibers() const noexcept {
+        return nullptr != heap_ || ! rqueue_.empty() || nullptr != dispatcher_;
+    }
+
+    // reorders a ready fiber according to its new deadline
+    virtual void property_change( context *, deadline_props &) noexcept;
+
+    virtual void suspend_until( std::chrono::steady_clock::time_point const&) noexcept;
+
+    virtual void notify() noexcept;
+};
+
+inline
+void
+deadline_props::notify_() noexcept {
+    if ( heap_linked_) {
+        // fiber_properties::notify() ignores fibers which are not
+        // linked into a ready-queue of type scheduler::ready_queue_t
+        static_cast< earliest_deadline_first * >( sched_algo_)->property_change( ctx_, * this);
+    } else {
+        notify();
+    }
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_EARLIEST_DEADLINE_FIRST_H
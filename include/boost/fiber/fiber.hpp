@@ -33,6 +33,7 @@ namespace fibers {
 class BOOST_FIBERS_DECL fiber {
 private:
     friend class context;
+    friend class fiber_pool;
 
     typedef intrusive_ptr< context >  ptr_t;
 
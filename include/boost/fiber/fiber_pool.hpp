@@ -0,0 +1,147 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_FIBER_POOL_H
+#define BOOST_FIBERS_FIBER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/config.hpp>
+#include <boost/context/stack_traits.hpp>
+#include <boost/intrusive_ptr.hpp>
+
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/pool_task.hpp>
+#include <boost/fiber/detail/spinlock.hpp>
+#include <boost/fiber/fiber.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// worker context' (and their stacks) kept for reuse
+// a context is returned if the last reference to it is released,
+// this might happen in any thread
+class BOOST_FIBERS_DECL context_pool {
+private:
+    std::atomic< std::size_t >  use_count_{ 0 };
+    detail::spinlock            splk_{};
+    std::vector< context * >    idle_{};
+    std::size_t                 max_idle_;
+    std::size_t                 stack_size_;
+    bool                        closed_{ false };
+
+    context * create_();
+
+public:
+    context_pool( std::size_t max_idle, std::size_t stack_size);
+
+    context_pool( context_pool const&) = delete;
+    context_pool & operator=( context_pool const&) = delete;
+
+    // storage on the stack of a pooled context for the task
+    static void * task_storage( context * ctx) noexcept {
+        return reinterpret_cast< char * >( ctx) + sizeof( context);
+    }
+
+    // idle context or a new one
+    context * get();
+
+    // binds task to ctx, returns the first reference
+    intrusive_ptr< context > launch( context * ctx, pool_task * task) noexcept;
+
+    // keeps ctx for reuse (or destroys it if the pool is closed or full)
+    void recycle( context * ctx) noexcept;
+
+    // destroys the idle context', context' released later are destroyed
+    void close() noexcept;
+
+    std::size_t idle() noexcept;
+
+    friend void intrusive_ptr_add_ref( context_pool * p) noexcept {
+        ++p->use_count_;
+    }
+
+    friend void intrusive_ptr_release( context_pool * p) noexcept {
+        if ( 0 == --p->use_count_) {
+            delete p;
+        }
+    }
+};
+
+}
+
+// launches fibers on recycled worker context': a terminated fiber
+// keeps its stack and control block, the next launched function
+// is bound to it
+class BOOST_FIBERS_DECL fiber_pool {
+private:
+    intrusive_ptr< detail::context_pool >   impl_;
+
+public:
+    // max_idle   - number of terminated context' kept for reuse
+    // stack_size - size of the stacks allocated by the pool
+    explicit fiber_pool( std::size_t max_idle = 64,
+                         std::size_t stack_size = boost::context::stack_traits::default_size() );
+
+    ~fiber_pool();
+
+    fiber_pool( fiber_pool const&) = delete;
+    fiber_pool & operator=( fiber_pool const&) = delete;
+
+    template< typename Fn, typename ... Args >
+    fiber launch( Fn && fn, Args && ... args) {
+        typedef detail::pool_task_impl<
+            typename std::decay< Fn >::type,
+            std::tuple< typename std::decay< Args >::type ... >
+        >                                               task_t;
+        context * ctx = impl_->get();
+        detail::pool_task * task = nullptr;
+        try {
+            if ( sizeof( task_t) <= BOOST_FIBERS_POOL_TASK_SIZE &&
+                 alignof( task_t) <= alignof( context) ) {
+                // constructed on the stack of the pooled context
+                task = ::new ( detail::context_pool::task_storage( ctx) ) task_t(
+                        false,
+                        std::forward< Fn >( fn),
+                        std::make_tuple( std::forward< Args >( args) ... ) );
+            } else {
+                task = new task_t(
+                        true,
+                        std::forward< Fn >( fn),
+                        std::make_tuple( std::forward< Args >( args) ... ) );
+            }
+        } catch (...) {
+            impl_->recycle( ctx);
+            throw;
+        }
+        fiber f;
+        f.impl_ = impl_->launch( ctx, task);
+        f.start_();
+        return f;
+    }
+
+    // number of context' ready for reuse
+    std::size_t idle() const noexcept;
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_FIBER_POOL_H
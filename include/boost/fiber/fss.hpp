@@ -9,6 +9,8 @@
 #ifndef BOOST_FIBERS_FSS_H
 #define BOOST_FIBERS_FSS_H
 
+#include <cstddef>
+
 #include <boost/config.hpp>
 
 #include <boost/fiber/context.hpp>
@@ -45,24 +47,29 @@ private:
     };
 
     detail::fss_cleanup_function::ptr_t cleanup_fn_;
+    // index of the slot in the fiber-specific storage of a context
+    std::size_t                         key_;
 
 public:
     typedef T   element_type;
 
     fiber_specific_ptr() :
-        cleanup_fn_{ new default_cleanup_function() } {
+        cleanup_fn_{ new default_cleanup_function() },
+        key_{ detail::fss_key_create() } {
     }
 
     explicit fiber_specific_ptr( void(*fn)(T*) ) :
-        cleanup_fn_{ new custom_cleanup_function( fn) } {
+        cleanup_fn_{ new custom_cleanup_function( fn) },
+        key_{ detail::fss_key_create() } {
     }
 
     ~fiber_specific_ptr() {
         context * f = context::active();
         if ( nullptr != f) {
             f->set_fss_data(
-                this, cleanup_fn_, nullptr, true);
+                key_, cleanup_fn_, nullptr, true);
         }
+        detail::fss_key_delete( key_);
     }
 
     fiber_specific_ptr( fiber_specific_ptr const&) = delete;
@@ -70,7 +77,7 @@ public:
 
     T * get() const noexcept {
         BOOST_ASSERT( context::active() );
-        void * vp = context::active()->get_fss_data( this);
+        void * vp = context::active()->get_fss_data( key_, cleanup_fn_.get() );
         return static_cast< T * >( vp);
     }
 
@@ -85,7 +92,7 @@ public:
     T * release() noexcept {
         T * tmp = get();
         context::active()->set_fss_data(
-            this, cleanup_fn_, nullptr, false);
+            key_, cleanup_fn_, nullptr, false);
         return tmp;
     }
 
@@ -93,7 +100,7 @@ public:
         T * c = get();
         if ( c != t) {
             context::active()->set_fss_data(
-                this, cleanup_fn_, t, true);
+                key_, cleanup_fn_, t, true);
         }
     }
 };
@@ -0,0 +1,67 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_LATCH_H
+#define BOOST_FIBERS_LATCH_H
+
+#include <atomic>
+#include <cstddef>
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/spinlock.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+// single-use: the counter is decremented atomically, the fiber
+// reaching zero wakes all waiting fibers at once
+class BOOST_FIBERS_DECL latch {
+private:
+    typedef context::wait_queue_t   wait_queue_t;
+
+    // the last count_down() has taken the waiting fibers, zero is
+    // stored as its last access (a fiber returning from wait() might
+    // destroy the latch)
+    static constexpr std::ptrdiff_t closing = -1;
+
+    std::atomic< std::ptrdiff_t >   count_;
+    wait_queue_t                    wait_queue_{};
+    detail::spinlock                wait_queue_splk_{};
+
+public:
+    explicit latch( std::ptrdiff_t);
+
+    ~latch() {
+        BOOST_ASSERT( wait_queue_.empty() );
+    }
+
+    latch( latch const&) = delete;
+    latch & operator=( latch const&) = delete;
+
+    void count_down( std::ptrdiff_t n = 1);
+
+    bool try_wait() const noexcept {
+        return 0 == count_.load( std::memory_order_acquire);
+    }
+
+    void wait() noexcept;
+
+    void arrive_and_wait( std::ptrdiff_t n = 1);
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_LATCH_H
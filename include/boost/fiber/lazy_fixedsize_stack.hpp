@@ -0,0 +1,129 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_LAZY_FIXEDSIZE_STACK_H
+#define BOOST_FIBERS_LAZY_FIXEDSIZE_STACK_H
+
+extern "C" {
+#include <sys/mman.h>
+#include <unistd.h>
+}
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <boost/context/stack_context.hpp>
+#include <boost/context/stack_traits.hpp>
+#include <boost/core/ignore_unused.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+
+#if defined(BOOST_USE_VALGRIND)
+#include <valgrind/valgrind.h>
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+// reserves address space for the stack without committing memory
+// (MAP_NORESERVE), pages are backed by physical memory when they are
+// touched for the first time
+// a guard page is appended at the end of the stack, the top
+// prefault_size bytes are touched at allocation
+template< typename traitsT >
+class basic_lazy_fixedsize_stack {
+private:
+    std::size_t     size_;
+    std::size_t     prefault_size_;
+
+public:
+    typedef traitsT traits_type;
+
+    basic_lazy_fixedsize_stack( std::size_t size = traits_type::default_size(),
+                                std::size_t prefault_size = traits_type::page_size() ) noexcept :
+        size_( size),
+        prefault_size_( prefault_size) {
+    }
+
+protected:
+    // reserves the stack and the guard page
+    boost::context::stack_context map_() const {
+        const std::size_t page_size = traits_type::page_size();
+        // calculate how many pages are required
+        const std::size_t pages = ( size_ + page_size - 1) / page_size;
+        // add one page at bottom that will be used as guard-page
+        const std::size_t size = ( pages + 1) * page_size;
+        int flags = MAP_PRIVATE;
+#if defined(MAP_ANON)
+        flags |= MAP_ANON;
+#else
+        flags |= MAP_ANONYMOUS;
+#endif
+#if defined(MAP_NORESERVE)
+        flags |= MAP_NORESERVE;
+#endif
+#if defined(BOOST_CONTEXT_USE_MAP_STACK)
+        flags |= MAP_STACK;
+#endif
+        void * vp = ::mmap( 0, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if ( MAP_FAILED == vp) {
+            throw std::bad_alloc();
+        }
+        const int result = ::mprotect( vp, page_size, PROT_NONE);
+        boost::ignore_unused( result);
+        BOOST_ASSERT( 0 == result);
+        boost::context::stack_context sctx;
+        sctx.size = size;
+        sctx.sp = static_cast< char * >( vp) + sctx.size;
+#if defined(BOOST_USE_VALGRIND)
+        sctx.valgrind_stack_id = VALGRIND_STACK_REGISTER( sctx.sp, vp);
+#endif
+        return sctx;
+    }
+
+    // the control structures are placed at the top of the stack,
+    // touch these pages now instead of faulting them in one by one
+    void prefault_( boost::context::stack_context const& sctx) const noexcept {
+        const std::size_t page_size = traits_type::page_size();
+        const std::size_t prefault = ( std::min)( ( prefault_size_ + page_size - 1) / page_size,
+                                                  sctx.size / page_size - 1);
+        for ( std::size_t i = 1; i <= prefault; ++i) {
+            * ( static_cast< char volatile * >( sctx.sp) - i * page_size) = 0;
+        }
+    }
+
+public:
+    boost::context::stack_context allocate() {
+        boost::context::stack_context sctx = map_();
+        prefault_( sctx);
+        return sctx;
+    }
+
+    void deallocate( boost::context::stack_context & sctx) noexcept {
+        BOOST_ASSERT( sctx.sp);
+#if defined(BOOST_USE_VALGRIND)
+        VALGRIND_STACK_DEREGISTER( sctx.valgrind_stack_id);
+#endif
+        void * vp = static_cast< char * >( sctx.sp) - sctx.size;
+        ::munmap( vp, sctx.size);
+    }
+};
+
+typedef basic_lazy_fixedsize_stack< boost::context::stack_traits >  lazy_fixedsize_stack;
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_LAZY_FIXEDSIZE_STACK_H
@@ -13,7 +13,7 @@
 
 #include <boost/fiber/context.hpp>
 #include <boost/fiber/detail/config.hpp>
-#include <boost/fiber/detail/spinlock.hpp>
+#include <boost/fiber/detail/mutex_impl.hpp>
 
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
@@ -24,22 +24,24 @@ namespace fibers {
 
 class condition_variable;
 
+// selects the adaptive mode of mutex
+struct adaptive_spin_t {};
+
+constexpr adaptive_spin_t adaptive_spin = adaptive_spin_t();
+
 class BOOST_FIBERS_DECL mutex {
 private:
     friend class condition_variable;
 
-    typedef context::wait_queue_t   wait_queue_t;
-
-    context                 *   owner_{ nullptr };
-    wait_queue_t                wait_queue_{};
-    detail::spinlock            wait_queue_splk_{};
+    detail::mutex_impl          impl_{};
 
 public:
     mutex() = default;
 
-    ~mutex() {
-        BOOST_ASSERT( nullptr == owner_);
-        BOOST_ASSERT( wait_queue_.empty() );
+    // lock() spins while the owner is running in another thread
+    // instead of suspending the fiber at once
+    explicit mutex( adaptive_spin_t) noexcept :
+        impl_{ true } {
     }
 
     mutex( mutex const&) = delete;
@@ -47,7 +49,7 @@ public:
 
     void lock();
 
-    bool try_lock() noexcept;
+    bool try_lock();
 
     void unlock();
 };
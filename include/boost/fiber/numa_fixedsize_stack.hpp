@@ -0,0 +1,67 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_NUMA_FIXEDSIZE_STACK_H
+#define BOOST_FIBERS_NUMA_FIXEDSIZE_STACK_H
+
+#include <cstddef>
+
+#include <boost/config.hpp>
+#include <boost/context/stack_context.hpp>
+#include <boost/context/stack_traits.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/numa.hpp>
+#include <boost/fiber/lazy_fixedsize_stack.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+// lazy_fixedsize_stack whose pages are placed on a NUMA node,
+// by default on the node of the thread allocating the stack (the
+// scheduler of this thread runs the new fiber)
+template< typename traitsT >
+class basic_numa_fixedsize_stack : public basic_lazy_fixedsize_stack< traitsT > {
+private:
+    std::size_t     node_;
+
+public:
+    typedef traitsT traits_type;
+
+    static constexpr std::size_t local_node = static_cast< std::size_t >( -1);
+
+    basic_numa_fixedsize_stack( std::size_t size = traits_type::default_size(),
+                                std::size_t node = local_node,
+                                std::size_t prefault_size = traits_type::page_size() ) noexcept :
+        basic_lazy_fixedsize_stack< traitsT >( size, prefault_size),
+        node_( node) {
+    }
+
+    boost::context::stack_context allocate() {
+        boost::context::stack_context sctx = this->map_();
+        // memory policy must be set before the pages are touched
+        detail::numa_bind( static_cast< char * >( sctx.sp) - sctx.size, sctx.size,
+                           local_node == node_ ? detail::numa_current_node() : node_);
+        this->prefault_( sctx);
+        return sctx;
+    }
+};
+
+template< typename traitsT >
+constexpr std::size_t basic_numa_fixedsize_stack< traitsT >::local_node;
+
+typedef basic_numa_fixedsize_stack< boost::context::stack_traits >  numa_fixedsize_stack;
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_NUMA_FIXEDSIZE_STACK_H
@@ -80,6 +80,14 @@ bool has_ready_fibers() noexcept {
     return boost::fibers::context::active()->get_scheduler()->has_ready_fibers();
 }
 
+// fibers woken by mutex::unlock() or condition_variable::notify_one()
+// in this thread are resumed immediately, the waking fiber is
+// put to the ready-queue
+inline
+void use_handoff( bool handoff = true) noexcept {
+    boost::fibers::context::active()->get_scheduler()->set_handoff( handoff);
+}
+
 template< typename SchedAlgo, typename ... Args >
 void use_scheduling_algorithm( Args && ... args) noexcept {
     boost::fibers::context::active()->get_scheduler()
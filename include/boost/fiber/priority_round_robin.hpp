@@ -0,0 +1,159 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_PRIORITY_ROUND_ROBIN_H
+#define BOOST_FIBERS_PRIORITY_ROUND_ROBIN_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/fiber/algorithm.hpp>
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/autoreset_event.hpp>
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/ctz.hpp>
+#include <boost/fiber/properties.hpp>
+#include <boost/fiber/scheduler.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+// number of priority levels (at most 64)
+#if ! defined(BOOST_FIBERS_PRIORITY_LEVELS)
+# define BOOST_FIBERS_PRIORITY_LEVELS 32
+#endif
+
+namespace boost {
+namespace fibers {
+
+class priority_round_robin;
+
+class priority_props : public fiber_properties {
+private:
+    friend class priority_round_robin;
+
+    int             priority_{ 0 };
+    // level of the ready-queue the fiber has been stored in
+    std::size_t     level_{ 0 };
+
+public:
+    priority_props( context * ctx) noexcept :
+        fiber_properties( ctx) {
+    }
+
+    int get_priority() const noexcept {
+        return priority_;
+    }
+
+    // higher values are preferred, values outside of
+    // [0, BOOST_FIBERS_PRIORITY_LEVELS) are clamped
+    void set_priority( int priority) noexcept {
+        if ( priority != priority_) {
+            priority_ = priority;
+            notify();
+        }
+    }
+};
+
+// one ready-queue per priority level, fibers of the same level are
+// resumed in round-robin fashion
+// a bitmap of the non-empty levels is kept: awakened() and pick_next()
+// are O(1)
+class BOOST_FIBERS_DECL priority_round_robin : public sched_algorithm_with_properties< priority_props > {
+public:
+    enum {
+        levels = BOOST_FIBERS_PRIORITY_LEVELS
+    };
+
+private:
+    static_assert( 0 < levels && levels <= 64, "BOOST_FIBERS_PRIORITY_LEVELS must be in [1, 64]");
+
+    typedef scheduler::ready_queue_t    rqueue_t;
+
+    rqueue_t                    rqueues_[levels]{};
+    // bit levels - 1 - l is set if level l is not empty,
+    // the lowest set bit denotes the highest non-empty level
+    std::uint64_t               mask_{ 0 };
+    // the dispatcher-context is kept apart, it must run even
+    // if fibers of higher priority keep yielding
+    context                 *   dispatcher_{ nullptr };
+    std::size_t                 ticks_{ 0 };
+    detail::autoreset_event     ev_{};
+
+    static std::size_t level_of_( int priority) noexcept {
+        return 0 > priority
+            ? 0
+            : ( levels <= priority ? levels - 1 : static_cast< std::size_t >( priority) );
+    }
+
+    static std::uint64_t bit_( std::size_t level) noexcept {
+        return std::uint64_t( 1) << ( levels - 1 - level);
+    }
+
+public:
+    priority_round_robin() = default;
+
+    priority_round_robin( priority_round_robin const&) = delete;
+    priority_round_robin & operator=( priority_round_robin const&) = delete;
+
+    virtual void awakened( context * ctx, priority_props & props) noexcept {
+        BOOST_ASSERT( nullptr != ctx);
+        BOOST_ASSERT( ! ctx->ready_is_linked() );
+        if ( ctx->is_dispatcher_context() ) {
+            dispatcher_ = ctx;
+            return;
+        }
+        std::size_t level = level_of_( props.priority_);
+        props.level_ = level;
+        ctx->ready_link( rqueues_[level]);
+        mask_ |= bit_( level);
+    }
+
+    virtual context * pick_next() noexcept {
+        context * ctx = nullptr;
+        // resume the dispatcher-context first from time to time
+        // (sleeping and remotely signaled fibers)
+        if ( nullptr != dispatcher_ && 0 == ( ++ticks_ % 61) ) {
+            std::swap( ctx, dispatcher_);
+            return ctx;
+        }
+        if ( 0 != mask_) {
+            std::size_t level = levels - 1 - detail::ctz( mask_);
+            ctx = & rqueues_[level].front();
+            rqueues_[level].pop_front();
+            if ( rqueues_[level].empty() ) {
+                mask_ &= ~bit_( level);
+            }
+            return ctx;
+        }
+        std::swap( ctx, dispatcher_);
+        return ctx;
+    }
+
+    virtual bool has_ready_fibers() const noexcept {
+        return 0 != mask_ || nullptr != dispatcher_;
+    }
+
+    // moves a ready fiber to the level of its new priority
+    virtual void property_change( context *, priority_props &) noexcept;
+
+    virtual void suspend_until( std::chrono::steady_clock::time_point const&) noexcept;
+
+    virtual void notify() noexcept;
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_PRIORITY_ROUND_ROBIN_H
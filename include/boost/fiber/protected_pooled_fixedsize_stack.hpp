@@ -0,0 +1,30 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_PROTECTED_POOLED_FIXEDSIZE_STACK_H
+#define BOOST_FIBERS_PROTECTED_POOLED_FIXEDSIZE_STACK_H
+
+#include <boost/config.hpp>
+#include <boost/context/protected_fixedsize_stack.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/stack_pool.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+using protected_pooled_fixedsize_stack = detail::basic_pooled_stack< boost::context::protected_fixedsize_stack >;
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_PROTECTED_POOLED_FIXEDSIZE_STACK_H
@@ -17,7 +17,7 @@
 
 #include <boost/fiber/context.hpp>
 #include <boost/fiber/detail/config.hpp>
-#include <boost/fiber/detail/spinlock.hpp>
+#include <boost/fiber/detail/mutex_impl.hpp>
 
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
@@ -32,20 +32,15 @@ class BOOST_FIBERS_DECL recursive_mutex {
 private:
     friend class condition_variable;
 
-    typedef context::wait_queue_t   wait_queue_t;
-
-    context                 *   owner_{ nullptr };
+    detail::mutex_impl          impl_{};
+    // modified by the owner only
     std::size_t                 count_{ 0 };
-    wait_queue_t                wait_queue_{};
-    detail::spinlock            wait_queue_splk_{};
 
 public:
     recursive_mutex() = default;
 
     ~recursive_mutex() {
-        BOOST_ASSERT( nullptr == owner_);
         BOOST_ASSERT( 0 == count_);
-        BOOST_ASSERT( wait_queue_.empty() );
     }
 
     recursive_mutex( recursive_mutex const&) = delete;
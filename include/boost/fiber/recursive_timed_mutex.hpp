@@ -19,7 +19,7 @@
 #include <boost/fiber/context.hpp>
 #include <boost/fiber/detail/config.hpp>
 #include <boost/fiber/detail/convert.hpp>
-#include <boost/fiber/detail/spinlock.hpp>
+#include <boost/fiber/detail/mutex_impl.hpp>
 
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
@@ -34,12 +34,9 @@ class BOOST_FIBERS_DECL recursive_timed_mutex {
 private:
     friend class condition_variable;
 
-    typedef context::wait_queue_t   wait_queue_t;
-
-    context                 *   owner_{ nullptr };
+    detail::mutex_impl          impl_{};
+    // modified by the owner only
     std::size_t                 count_{ 0 };
-    wait_queue_t                wait_queue_{};
-    detail::spinlock            wait_queue_splk_{};
 
     bool try_lock_until_( std::chrono::steady_clock::time_point const& timeout_time) noexcept;
 
@@ -47,9 +44,7 @@ public:
     recursive_timed_mutex() = default;
 
     ~recursive_timed_mutex() {
-        BOOST_ASSERT( nullptr == owner_);
         BOOST_ASSERT( 0 == count_);
-        BOOST_ASSERT( wait_queue_.empty() );
     }
 
     recursive_timed_mutex( recursive_timed_mutex const&) = delete;
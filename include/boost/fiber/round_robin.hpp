@@ -8,6 +8,7 @@
 
 #include <chrono>
 
+#include <boost/assert.hpp>
 #include <boost/config.hpp>
 
 #include <boost/fiber/algorithm.hpp>
@@ -31,11 +32,33 @@ private:
     detail::autoreset_event     ev_{};
 
 public:
-    virtual void awakened( context *) noexcept;
-
-    virtual context * pick_next() noexcept;
-
-    virtual bool has_ready_fibers() const noexcept;
+    // defined inline, the scheduler binds them statically
+    // if round_robin is used (see scheduler::rr_)
+    virtual void awakened( context * ctx) noexcept {
+        BOOST_ASSERT( nullptr != ctx);
+        BOOST_ASSERT( ! ctx->ready_is_linked() );
+        ctx->ready_link( ready_queue_);
+    }
+
+    virtual void awakened_batch( ready_queue_type & batch) noexcept {
+        // O(1)
+        ready_queue_.splice( ready_queue_.end(), batch);
+    }
+
+    virtual context * pick_next() noexcept {
+        context * victim{ nullptr };
+        if ( ! ready_queue_.empty() ) {
+            victim = & ready_queue_.front();
+            ready_queue_.pop_front();
+            BOOST_ASSERT( nullptr != victim);
+            BOOST_ASSERT( ! victim->ready_is_linked() );
+        }
+        return victim;
+    }
+
+    virtual bool has_ready_fibers() const noexcept {
+        return ! ready_queue_.empty();
+    }
 
     virtual void suspend_until( std::chrono::steady_clock::time_point const&) noexcept;
 
@@ -0,0 +1,127 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_RUNTIME_H
+#define BOOST_FIBERS_RUNTIME_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/pool_task.hpp>
+#include <boost/fiber/future/future.hpp>
+#include <boost/fiber/future/packaged_task.hpp>
+#include <boost/fiber/unbounded_channel.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+// runs fibers on a set of threads, each thread owns a scheduler
+// functions might be posted from any thread, each function is
+// launched as a detached fiber by the thread it has been posted to
+class BOOST_FIBERS_DECL runtime {
+private:
+    typedef unbounded_channel< detail::pool_task * >    queue_t;
+
+    std::size_t                         size_;
+    std::unique_ptr< queue_t[] >        queues_;
+    std::vector< std::thread >          threads_{};
+    // CPUs the threads are pinned to, ordered by NUMA node
+    std::vector< std::size_t >          cpus_{};
+    std::atomic< std::size_t >          next_{ 0 };
+
+    void run_( std::size_t, bool, std::function< void( std::size_t) > const&);
+
+    void post_( std::size_t, detail::pool_task *);
+
+public:
+    // size - number of threads (hardware concurrency if 0)
+    // pin  - bind each thread to a CPU (Linux only), CPUs are assigned
+    //        node by node: threads with adjacent indices share a NUMA node
+    // init - called by each thread (with its index) before the first
+    //        fiber is launched, e.g. to install a scheduling algorithm
+    explicit runtime( std::size_t size = 0, bool pin = false,
+                      std::function< void( std::size_t) > init = std::function< void( std::size_t) >() );
+
+    // closes the runtime and waits for the threads
+    ~runtime();
+
+    runtime( runtime const&) = delete;
+    runtime & operator=( runtime const&) = delete;
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    // launches fn( args ...) as a detached fiber in thread idx
+    template< typename Fn, typename ... Args >
+    void post_to( std::size_t idx, Fn && fn, Args && ... args) {
+        typedef detail::pool_task_impl<
+            typename std::decay< Fn >::type,
+            std::tuple< typename std::decay< Args >::type ... >
+        >                                               task_t;
+        BOOST_ASSERT( idx < size_);
+        post_( idx, new task_t(
+                        true,
+                        std::forward< Fn >( fn),
+                        std::make_tuple( std::forward< Args >( args) ... ) ) );
+    }
+
+    // launches fn( args ...) as a detached fiber,
+    // threads are chosen round-robin
+    template< typename Fn, typename ... Args >
+    void post( Fn && fn, Args && ... args) {
+        post_to( next_.fetch_add( 1, std::memory_order_relaxed) % size_,
+                 std::forward< Fn >( fn), std::forward< Args >( args) ... );
+    }
+
+    template< typename Fn, typename ... Args >
+    future<
+        typename std::result_of<
+            typename std::decay< Fn >::type( typename std::decay< Args >::type ... )
+        >::type
+    >
+    submit( Fn && fn, Args && ... args) {
+        typedef typename std::result_of<
+            typename std::decay< Fn >::type( typename std::decay< Args >::type ... )
+        >::type     result_t;
+
+        packaged_task< result_t( typename std::decay< Args >::type ... ) > pt{
+            std::forward< Fn >( fn) };
+        future< result_t > f{ pt.get_future() };
+        post( std::move( pt), std::forward< Args >( args) ... );
+        return f;
+    }
+
+    // functions posted later are rejected, each thread launches the
+    // functions already posted, waits till all its fibers have
+    // terminated and exits
+    void close() noexcept;
+
+    // waits till all threads have exited
+    void join();
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_RUNTIME_H
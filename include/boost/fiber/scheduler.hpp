@@ -6,7 +6,10 @@
 #ifndef BOOST_FIBERS_FIBER_MANAGER_H
 #define BOOST_FIBERS_FIBER_MANAGER_H
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -18,8 +21,11 @@
 
 #include <boost/fiber/algorithm.hpp>
 #include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/clock.hpp>
 #include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/mpsc_queue.hpp>
 #include <boost/fiber/detail/spinlock.hpp>
+#include <boost/fiber/detail/timer_wheel.hpp>
 
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
@@ -28,6 +34,29 @@
 namespace boost {
 namespace fibers {
 
+// snapshot of the counters of a scheduler
+struct scheduler_stats {
+    // switches from one context to another
+    std::uint64_t                               context_switches{ 0 };
+    // highest number of ready fibers (approximated if fibers are
+    // migrated to other threads, e.g. by work_stealing)
+    std::size_t                                 ready_queue_high_water{ 0 };
+    // fibers woken up by other threads
+    std::uint64_t                               remote_wakeups{ 0 };
+    // fibers currently blocked with a timeout
+    std::size_t                                 sleep_queue_size{ 0 };
+    // time spent in sched_algorithm::suspend_until()
+    std::chrono::steady_clock::duration         idle_time{ 0 };
+    // fibers attached to this scheduler (created in this
+    // thread or migrated to it)
+    std::uint64_t                               fibers_created{ 0 };
+    std::uint64_t                               fibers_terminated{ 0 };
+    // time spent releasing terminated fibers
+    std::chrono::steady_clock::duration         release_terminated_time{ 0 };
+};
+
+class round_robin;
+
 class BOOST_FIBERS_DECL scheduler {
 public:
     struct timepoint_less {
@@ -36,23 +65,35 @@ public:
         }
     };
 
-    typedef intrusive::list<
-                context,
-                intrusive::member_hook<
-                    context, detail::ready_hook, & context::ready_hook_ >,
-                intrusive::constant_time_size< false > >    ready_queue_t;
+    struct timepoint_of {
+        std::chrono::steady_clock::time_point const& operator()( context const& c) const noexcept {
+            return c.tp_;
+        }
+    };
+
+    typedef sched_algorithm::ready_queue_type               ready_queue_t;
 private:
-    typedef intrusive::list<
-                context,
-                intrusive::member_hook<
-                    context, detail::remote_ready_hook, & context::remote_ready_hook_ >,
-                intrusive::constant_time_size< false > >    remote_ready_queue_t;
+    typedef detail::mpsc_queue<
+                context, & context::remote_ready_hook_ >    remote_ready_queue_t;
+#if defined(BOOST_FIBERS_USE_TIMER_WHEEL)
+    // O(1) insert/cancel, deadlines are rounded up to 100 microseconds
+    typedef detail::timer_wheel<
+                intrusive::list<
+                    context,
+                    intrusive::member_hook<
+                        context, detail::sleep_hook, & context::sleep_hook_ >,
+                    intrusive::constant_time_size< false > >,
+                timepoint_of,
+                std::chrono::duration<
+                    std::int64_t, std::ratio< 1, 10000 > > >    sleep_queue_t;
+#else
     typedef intrusive::set<
                 context,
                 intrusive::member_hook<
                     context, detail::sleep_hook, & context::sleep_hook_ >,
                 intrusive::constant_time_size< false >,
                 intrusive::compare< timepoint_less > >      sleep_queue_t;
+#endif
     typedef intrusive::list<
                 context,
                 intrusive::member_hook<
@@ -65,6 +106,12 @@ private:
                 intrusive::constant_time_size< false > >    worker_queue_t;
 
     std::unique_ptr< sched_algorithm >  sched_algo_;
+    // sched_algo_ if its dynamic type is round_robin: the calls of the
+    // hot path (awakened(), pick_next()) are bound statically and inlined
+    round_robin                     *   rr_{ nullptr };
+    // bytes reserved for the fiber_properties of sched_algo_ on the
+    // stack of new fibers
+    std::size_t                         properties_size_{ 0 };
     context                         *   main_ctx_{ nullptr };
     intrusive_ptr< context >            dispatcher_ctx_{};
     // worker-queue contains all context' mananged by this scheduler
@@ -75,13 +122,55 @@ private:
     terminated_queue_t                  terminated_queue_{};
     // remote ready-queue contains context' signaled by schedulers
     // running in other threads
-    remote_ready_queue_t                remote_ready_queue_{};
+    // lock-free: producers push, dispatcher drains all at once
+    // written by other threads, kept on a cache line of its own
+    alignas(BOOST_FIBERS_CACHELINE_LENGTH) remote_ready_queue_t remote_ready_queue_{};
     // sleep-queue cotnains context' whic hahve been called
     // scheduler::wait_until()
-    sleep_queue_t                       sleep_queue_{};
+    alignas(BOOST_FIBERS_CACHELINE_LENGTH) sleep_queue_t        sleep_queue_{};
+    // clock used to expire deadlines, read once per pass of the
+    // dispatch loop if the sleep-queue is not empty
+    detail::clock                       clock_{};
     bool                                shutdown_{ false };
-    detail::spinlock                    remote_ready_splk_{};
+    // switch directly to fibers woken by mutex::unlock() and
+    // condition_variable::notify_one()
+    bool                                handoff_{ false };
     detail::spinlock                    worker_splk_{};
+    // main-context waiting in drain() for the worker-queue to become
+    // empty, guarded by worker_splk_
+    context                         *   drain_ctx_{ nullptr };
+    // written by the thread running the scheduler only,
+    // read by stats() from any thread
+    struct counters_t {
+        std::atomic< std::uint64_t >                                context_switches{ 0 };
+        std::atomic< std::size_t >                                  ready{ 0 };
+        std::atomic< std::size_t >                                  ready_high_water{ 0 };
+        std::atomic< std::uint64_t >                                remote_wakeups{ 0 };
+        std::atomic< std::size_t >                                  sleeping{ 0 };
+        std::atomic< std::chrono::steady_clock::duration::rep >     idle_time{ 0 };
+        std::atomic< std::uint64_t >                                fibers_created{ 0 };
+        std::atomic< std::uint64_t >                                fibers_terminated{ 0 };
+        std::atomic< std::chrono::steady_clock::duration::rep >     release_terminated_time{ 0 };
+    }                                   counters_{};
+    // context resumed last, written by the thread running the scheduler
+    // only, read by fibers of other threads spinning in mutex::lock()
+    std::atomic< context * >            running_{ nullptr };
+
+    // single writer, no read-modify-write required
+    template< typename T >
+    static void add_( std::atomic< T > & counter, T n) noexcept {
+        counter.store( counter.load( std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void count_ready_() noexcept;
+
+    void prepare_ready_( context *) noexcept;
+
+    void awakened_( context *) noexcept;
+
+    context * pick_next_() noexcept;
+
+    bool has_ready_fibers_() const noexcept;
 
     void resume_( context *, context *) noexcept;
     void resume_( context *, context *, detail::spinlock_lock &) noexcept;
@@ -91,10 +180,14 @@ private:
 
     void release_terminated_() noexcept;
 
+    void drained_() noexcept;
+
     void remote_ready2ready_() noexcept;
 
     void sleep2ready_() noexcept;
 
+    std::chrono::steady_clock::time_point next_deadline_() noexcept;
+
 public:
     scheduler() noexcept;
 
@@ -107,12 +200,20 @@ public:
 
     void set_ready( context *) noexcept;
 
+    // marks context as ready and appends it to a batch,
+    // the batch is passed to the scheduling algorithm by set_ready( batch)
+    void set_ready( context *, ready_queue_t &) noexcept;
+
+    void set_ready( ready_queue_t &) noexcept;
+
     void set_remote_ready( context *) noexcept;
 
     void set_terminated( context *) noexcept;
 
     void yield( context *) noexcept;
 
+    void handoff( context *, context *) noexcept;
+
     bool wait_until( context *,
                      std::chrono::steady_clock::time_point const&) noexcept;
     bool wait_until( context *,
@@ -125,8 +226,28 @@ public:
 
     bool has_ready_fibers() const noexcept;
 
+    // true if ctx is running in the thread of this scheduler,
+    // might be called from other threads (the result is a hint)
+    bool is_running( context * ctx) const noexcept {
+        return ctx == running_.load( std::memory_order_relaxed);
+    }
+
+    // suspends the main-context until all worker fibers of this scheduler
+    // have terminated (or have been migrated to other schedulers)
+    void drain( context *) noexcept;
+
+    scheduler_stats stats() const noexcept;
+
+    void set_handoff( bool) noexcept;
+
+    bool handoff_enabled() const noexcept;
+
     void set_sched_algo( std::unique_ptr< sched_algorithm >) noexcept;
 
+    std::size_t properties_size() const noexcept {
+        return properties_size_;
+    }
+
     void attach_main_context( context *) noexcept;
 
     void attach_dispatcher_context( intrusive_ptr< context >) noexcept;
@@ -0,0 +1,62 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_SHARED_MUTEX_H
+#define BOOST_FIBERS_SHARED_MUTEX_H
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/shared_mutex_impl.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+// selects the phase-fair policy of shared_mutex and shared_timed_mutex
+struct phase_fair_t {};
+
+constexpr phase_fair_t phase_fair = phase_fair_t();
+
+class BOOST_FIBERS_DECL shared_mutex {
+private:
+    detail::shared_mutex_impl   impl_{};
+
+public:
+    // writer-preferring
+    shared_mutex() = default;
+
+    // read and write phases alternate
+    explicit shared_mutex( phase_fair_t) noexcept :
+        impl_{ true } {
+    }
+
+    shared_mutex( shared_mutex const&) = delete;
+    shared_mutex & operator=( shared_mutex const&) = delete;
+
+    void lock();
+
+    bool try_lock();
+
+    void unlock();
+
+    void lock_shared();
+
+    bool try_lock_shared();
+
+    void unlock_shared();
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_SHARED_MUTEX_H
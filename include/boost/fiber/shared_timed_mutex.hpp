@@ -0,0 +1,89 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_SHARED_TIMED_MUTEX_H
+#define BOOST_FIBERS_SHARED_TIMED_MUTEX_H
+
+#include <chrono>
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/convert.hpp>
+#include <boost/fiber/detail/shared_mutex_impl.hpp>
+#include <boost/fiber/shared_mutex.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+class BOOST_FIBERS_DECL shared_timed_mutex {
+private:
+    detail::shared_mutex_impl   impl_{};
+
+    bool try_lock_until_( std::chrono::steady_clock::time_point const& timeout_time) noexcept;
+
+    bool try_lock_shared_until_( std::chrono::steady_clock::time_point const& timeout_time) noexcept;
+
+public:
+    // writer-preferring
+    shared_timed_mutex() = default;
+
+    // read and write phases alternate
+    explicit shared_timed_mutex( phase_fair_t) noexcept :
+        impl_{ true } {
+    }
+
+    shared_timed_mutex( shared_timed_mutex const&) = delete;
+    shared_timed_mutex & operator=( shared_timed_mutex const&) = delete;
+
+    void lock();
+
+    bool try_lock();
+
+    template< typename Clock, typename Duration >
+    bool try_lock_until( std::chrono::time_point< Clock, Duration > const& timeout_time_) {
+        std::chrono::steady_clock::time_point timeout_time(
+                detail::convert( timeout_time_) );
+        return try_lock_until_( timeout_time);
+    }
+
+    template< typename Rep, typename Period >
+    bool try_lock_for( std::chrono::duration< Rep, Period > const& timeout_duration) noexcept {
+        return try_lock_until_( std::chrono::steady_clock::now() + timeout_duration);
+    }
+
+    void unlock();
+
+    void lock_shared();
+
+    bool try_lock_shared();
+
+    template< typename Clock, typename Duration >
+    bool try_lock_shared_until( std::chrono::time_point< Clock, Duration > const& timeout_time_) {
+        std::chrono::steady_clock::time_point timeout_time(
+                detail::convert( timeout_time_) );
+        return try_lock_shared_until_( timeout_time);
+    }
+
+    template< typename Rep, typename Period >
+    bool try_lock_shared_for( std::chrono::duration< Rep, Period > const& timeout_duration) noexcept {
+        return try_lock_shared_until_( std::chrono::steady_clock::now() + timeout_duration);
+    }
+
+    void unlock_shared();
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_SHARED_TIMED_MUTEX_H
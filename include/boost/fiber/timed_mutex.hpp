@@ -15,7 +15,7 @@
 #include <boost/fiber/context.hpp>
 #include <boost/fiber/detail/config.hpp>
 #include <boost/fiber/detail/convert.hpp>
-#include <boost/fiber/detail/spinlock.hpp>
+#include <boost/fiber/detail/mutex_impl.hpp>
 
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
@@ -30,28 +30,19 @@ class BOOST_FIBERS_DECL timed_mutex {
 private:
     friend class condition_variable;
 
-    typedef context::wait_queue_t   wait_queue_t;
-
-    context                 *   owner_{ nullptr };
-    wait_queue_t                wait_queue_{};
-    detail::spinlock            wait_queue_splk_{};
+    detail::mutex_impl          impl_{};
 
     bool try_lock_until_( std::chrono::steady_clock::time_point const& timeout_time) noexcept;
 
 public:
     timed_mutex() = default;
 
-    ~timed_mutex() {
-        BOOST_ASSERT( nullptr == owner_);
-        BOOST_ASSERT( wait_queue_.empty() );
-    }
-
     timed_mutex( timed_mutex const&) = delete;
     timed_mutex & operator=( timed_mutex const&) = delete;
 
     void lock();
 
-    bool try_lock() noexcept;
+    bool try_lock();
 
     template< typename Clock, typename Duration >
     bool try_lock_until( std::chrono::time_point< Clock, Duration > const& timeout_time_) {
@@ -0,0 +1,104 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_TRACE_H
+#define BOOST_FIBERS_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/config.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+// capacity (records) of the per-thread trace buffer, a power of 2
+#if ! defined(BOOST_FIBERS_TRACE_BUFFER_SIZE)
+# define BOOST_FIBERS_TRACE_BUFFER_SIZE 65536
+#endif
+
+namespace boost {
+namespace fibers {
+
+enum class trace_event : std::uint8_t {
+    // fiber attached to the scheduler
+    create = 0,
+    // fiber resumed
+    resume,
+    // fiber switched away
+    suspend,
+    // fiber yielded
+    yield,
+    // fiber blocked with a timeout
+    sleep,
+    // fiber passed to the ready-queue
+    ready,
+    // fiber woken up by another thread (recorded by the waking thread)
+    remote_wakeup,
+    // fiber terminated
+    terminate
+};
+
+struct trace_record {
+    std::chrono::steady_clock::time_point   tp{};
+    context::id                             id{};
+    // thread which recorded the event, numbered in order
+    // of the first recorded event
+    std::uint32_t                           thread{ 0 };
+    trace_event                             event{ trace_event::create };
+};
+
+namespace detail {
+
+BOOST_FIBERS_DECL extern std::atomic< bool > trace_enabled_;
+
+BOOST_FIBERS_DECL void trace_push_( trace_event, context *) noexcept;
+
+inline
+void trace( trace_event ev, context * ctx) noexcept {
+    // a single relaxed load if tracing is disabled at runtime
+    if ( BOOST_UNLIKELY( trace_enabled_.load( std::memory_order_relaxed) ) ) {
+        trace_push_( ev, ctx);
+    }
+}
+
+}
+
+// enables/disables recording of events (only if the library
+// was built with BOOST_FIBERS_ENABLE_TRACE)
+BOOST_FIBERS_DECL void trace_enable( bool enable = true) noexcept;
+
+BOOST_FIBERS_DECL bool trace_enabled() noexcept;
+
+// removes the recorded events from the buffers of all threads,
+// ordered by time; events are dropped while the buffer of a
+// thread is full
+BOOST_FIBERS_DECL std::vector< trace_record > trace_collect();
+
+// writes records in the Chrome trace event format (JSON),
+// viewable with chrome://tracing or Perfetto
+// pid - thread, tid - fiber
+BOOST_FIBERS_DECL void trace_export_chrome( std::ostream &, std::vector< trace_record > const&);
+
+}}
+
+#if defined(BOOST_FIBERS_ENABLE_TRACE)
+# define BOOST_FIBERS_TRACE( ev, ctx) ::boost::fibers::detail::trace( ::boost::fibers::trace_event::ev, ctx)
+#else
+# define BOOST_FIBERS_TRACE( ev, ctx) ((void)0)
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_TRACE_H
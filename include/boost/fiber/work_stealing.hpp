@@ -0,0 +1,117 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_FIBERS_WORK_STEALING_H
+#define BOOST_FIBERS_WORK_STEALING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <random>
+
+#include <boost/config.hpp>
+
+#include <boost/fiber/algorithm.hpp>
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/detail/autoreset_event.hpp>
+#include <boost/fiber/detail/config.hpp>
+#include <boost/fiber/detail/context_spmc_queue.hpp>
+#include <boost/fiber/scheduler.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+class work_stealing;
+
+// group of schedulers (one per thread) stealing from each other
+// the group must outlive all work_stealing instances attached to it
+class BOOST_FIBERS_DECL work_stealing_group {
+private:
+    friend class work_stealing;
+
+    struct member {
+        detail::context_spmc_queue  rqueue{};
+        detail::autoreset_event     ev{};
+        std::atomic< bool >         idle{ false };
+        // NUMA node of the thread running the scheduler
+        std::atomic< std::size_t >  node{ 0 };
+    };
+
+    std::size_t                         size_;
+    // number of NUMA nodes
+    std::size_t                         nodes_;
+    std::unique_ptr< member[] >         members_;
+    std::atomic< std::size_t >          count_{ 0 };
+    std::atomic< std::size_t >          idle_{ 0 };
+
+    std::size_t attach_() noexcept;
+
+    bool has_work_() const noexcept;
+
+    void notify_idle_( std::size_t) noexcept;
+
+public:
+    explicit work_stealing_group( std::size_t size);
+
+    work_stealing_group( work_stealing_group const&) = delete;
+    work_stealing_group & operator=( work_stealing_group const&) = delete;
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+};
+
+class BOOST_FIBERS_DECL work_stealing : public sched_algorithm {
+private:
+    typedef scheduler::ready_queue_t    lqueue_t;
+
+    std::shared_ptr< work_stealing_group >  group_;
+    std::size_t                             idx_;
+    work_stealing_group::member         &   self_;
+    // main- and dispatcher-context are never stolen
+    lqueue_t                                pinned_queue_{};
+    std::minstd_rand                        generator_;
+    std::size_t                             ticks_{ 0 };
+    bool                                    suspend_;
+
+    context * steal_( bool) noexcept;
+
+    context * steal_() noexcept;
+
+    bool push_( context *) noexcept;
+
+    void notify_idle_() noexcept;
+
+public:
+    work_stealing( std::shared_ptr< work_stealing_group >, bool suspend = false);
+
+    work_stealing( work_stealing const&) = delete;
+    work_stealing & operator=( work_stealing const&) = delete;
+
+    virtual void awakened( context *) noexcept;
+
+    virtual void awakened_batch( ready_queue_type &) noexcept;
+
+    virtual context * pick_next() noexcept;
+
+    virtual bool has_ready_fibers() const noexcept;
+
+    virtual void suspend_until( std::chrono::steady_clock::time_point const&) noexcept;
+
+    virtual void notify() noexcept;
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_FIBERS_WORK_STEALING_H
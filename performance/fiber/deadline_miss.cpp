@@ -0,0 +1,126 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// measures the rate of missed deadlines of round_robin and
+// earliest_deadline_first
+// JOBS fibers are released at once, each job computes in slices of
+// SLICE micro seconds (yielding after each slice) and has a deadline
+// relative to the release; the offered load is the total work divided
+// by the latest deadline, load > 1 means overload
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/fiber/all.hpp>
+#include <boost/fiber/round_robin.hpp>
+
+#include "../clock.hpp"
+
+#ifndef JOBS
+#define JOBS 200
+#endif
+
+#ifndef SLICE
+#define SLICE 20
+#endif
+
+struct job {
+    std::size_t                 slices;
+    time_point_type             deadline;
+    bool                        missed{ false };
+};
+
+// demote: a job which has missed its deadline drops it and continues
+// after all jobs with deadline (FIFO), this way it does not delay jobs
+// which still can meet their deadlines
+void compute( job & j, bool demote) {
+    for ( std::size_t i = 0; i < j.slices; ++i) {
+        time_point_type end = clock_type::now() + std::chrono::microseconds( SLICE);
+        while ( clock_type::now() < end) {
+        }
+        if ( demote && end > j.deadline) {
+            boost::this_fiber::properties< boost::fibers::deadline_props >().clear_deadline();
+        }
+        boost::this_fiber::yield();
+    }
+    j.missed = clock_type::now() > j.deadline;
+}
+
+// fraction of jobs finishing after their deadline
+template< typename Algo >
+double measure( double load, bool edf, bool demote = false) {
+    double rate = 0.;
+    std::thread( [load,edf,demote,&rate](){
+        boost::fibers::use_scheduling_algorithm< Algo >();
+        // same jobs for both algorithms
+        std::minstd_rand rnd( 4711);
+        std::uniform_int_distribution< std::size_t > work( 1, 10);
+        std::uniform_real_distribution< double > slack( 0., 1.);
+        std::vector< job > jobs( JOBS);
+        std::size_t total = 0;
+        for ( job & j : jobs) {
+            j.slices = work( rnd);
+            total += j.slices;
+        }
+        // latest deadline, in slices
+        double horizon = total / load;
+        std::vector< boost::fibers::fiber > fibers;
+        for ( job & j : jobs) {
+            fibers.emplace_back( compute, std::ref( j), demote);
+        }
+        // all jobs are released now
+        time_point_type start = clock_type::now();
+        for ( std::size_t i = 0; i < jobs.size(); ++i) {
+            job & j = jobs[i];
+            double d = j.slices + slack( rnd) * std::max( 0., horizon - j.slices);
+            j.deadline = start + std::chrono::microseconds(
+                static_cast< std::int64_t >( d * SLICE) );
+            if ( edf) {
+                fibers[i].properties< boost::fibers::deadline_props >().set_deadline( j.deadline);
+            }
+        }
+        for ( boost::fibers::fiber & f : fibers) {
+            f.join();
+        }
+        rate = static_cast< double >(
+            std::count_if( jobs.begin(), jobs.end(), []( job const& j){ return j.missed; }) ) / jobs.size();
+    }).join();
+    return rate;
+}
+
+int main( int argc, char * argv[])
+{
+    try
+    {
+        std::cout << JOBS << " jobs, slices of " << SLICE << " micro seconds" << std::endl;
+        std::cout << std::fixed << std::setprecision( 1);
+        double loads[] = { 0.5, 0.8, 1.0, 1.2, 1.5, 2.0 };
+        for ( double load : loads) {
+            double rr = measure< boost::fibers::round_robin >( load, false);
+            double edf = measure< boost::fibers::earliest_deadline_first >( load, true);
+            double demoted = measure< boost::fibers::earliest_deadline_first >( load, true, true);
+            std::cout << "load " << load << ": missed deadlines round_robin "
+                      << 100. * rr << "%, earliest_deadline_first "
+                      << 100. * edf << "%, late jobs demoted "
+                      << 100. * demoted << "%" << std::endl;
+        }
+
+        return EXIT_SUCCESS;
+    }
+    catch ( std::exception const& e)
+    { std::cerr << "exception: " << e.what() << std::endl; }
+    catch (...)
+    { std::cerr << "unhandled exception" << std::endl; }
+    return EXIT_FAILURE;
+}
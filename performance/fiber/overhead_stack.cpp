@@ -0,0 +1,59 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// measures launching and joining a short-lived fiber
+// with different stack allocators
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <boost/cstdint.hpp>
+#include <boost/fiber/all.hpp>
+
+#include "../clock.hpp"
+
+#ifndef JOBS
+#define JOBS 100000
+#endif
+
+void worker() {}
+
+template< typename StackAllocator >
+duration_type measure( StackAllocator salloc) {
+    // warm-up
+    boost::fibers::fiber( std::allocator_arg, salloc, worker).join();
+    time_point_type start( clock_type::now() );
+    for ( int i = 0; i < JOBS; ++i) {
+        boost::fibers::fiber( std::allocator_arg, salloc, worker).join();
+    }
+    duration_type total = clock_type::now() - start;
+    return total / JOBS;
+}
+
+template< typename StackAllocator >
+void run( std::string const& name) {
+    boost::uint64_t res = measure( StackAllocator() ).count();
+    std::cout << name << ": average of " << res << " nano seconds" << std::endl;
+}
+
+int main( int argc, char * argv[])
+{
+    try
+    {
+        run< boost::fibers::fixedsize_stack >( "fixedsize_stack");
+        run< boost::fibers::pooled_fixedsize_stack >( "pooled_fixedsize_stack");
+        run< boost::fibers::protected_fixedsize_stack >( "protected_fixedsize_stack");
+        run< boost::fibers::protected_pooled_fixedsize_stack >( "protected_pooled_fixedsize_stack");
+
+        return EXIT_SUCCESS;
+    }
+    catch ( std::exception const& e)
+    { std::cerr << "exception: " << e.what() << std::endl; }
+    catch (...)
+    { std::cerr << "unhandled exception" << std::endl; }
+    return EXIT_FAILURE;
+}
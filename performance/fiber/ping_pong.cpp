@@ -0,0 +1,61 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// measures a synchronous exchange between two fibers
+// over unbounded channels, with and without handoff
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/cstdint.hpp>
+#include <boost/fiber/all.hpp>
+
+#include "../clock.hpp"
+
+#ifndef ROUNDS
+#define ROUNDS 100000
+#endif
+
+typedef boost::fibers::unbounded_channel< int > channel_t;
+
+duration_type measure( bool handoff) {
+    boost::fibers::use_handoff( handoff);
+    channel_t ping, pong;
+    boost::fibers::fiber f( [&ping,&pong](){
+                                int value = 0;
+                                while ( boost::fibers::channel_op_status::success == ping.pop( value) ) {
+                                    pong.push( value);
+                                }
+                            });
+    time_point_type start( clock_type::now() );
+    for ( int i = 0; i < ROUNDS; ++i) {
+        ping.push( i);
+        pong.value_pop();
+    }
+    duration_type total = clock_type::now() - start;
+    ping.close();
+    f.join();
+    boost::fibers::use_handoff( false);
+    return total / ROUNDS;
+}
+
+int main( int argc, char * argv[])
+{
+    try
+    {
+        boost::uint64_t res = measure( false).count();
+        std::cout << "ready-queue: average of " << res << " nano seconds per round trip" << std::endl;
+        res = measure( true).count();
+        std::cout << "handoff: average of " << res << " nano seconds per round trip" << std::endl;
+
+        return EXIT_SUCCESS;
+    }
+    catch ( std::exception const& e)
+    { std::cerr << "exception: " << e.what() << std::endl; }
+    catch (...)
+    { std::cerr << "unhandled exception" << std::endl; }
+    return EXIT_FAILURE;
+}
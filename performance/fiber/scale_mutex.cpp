@@ -0,0 +1,111 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// compares fibers::mutex with and without adaptive spinning:
+// N threads run two fibers each, all fibers repeatedly acquire the same
+// mutex and execute a short critical section (HOLD nano seconds)
+// the number of remote wakeups (scheduler::set_remote_ready()) is
+// reported too
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/fiber/all.hpp>
+
+#include "../clock.hpp"
+
+#ifndef ROUNDS
+#define ROUNDS 100000
+#endif
+
+#ifndef MAX_THREADS
+#define MAX_THREADS 8
+#endif
+
+#ifndef HOLD
+#define HOLD 200
+#endif
+
+void busy( std::chrono::nanoseconds ns) {
+    time_point_type end = clock_type::now() + ns;
+    while ( clock_type::now() < end) {
+    }
+}
+
+duration_type measure( boost::fibers::mutex & mtx, std::size_t n, std::uint64_t & wakeups) {
+    std::atomic< bool > go{ false };
+    std::atomic< std::uint64_t > remote{ 0 };
+    std::size_t counter = 0;
+    std::size_t rounds = ROUNDS / ( 2 * n);
+    std::vector< std::thread > threads;
+    for ( std::size_t i = 0; i < n; ++i) {
+        threads.emplace_back( [&mtx,&go,&remote,&counter,rounds](){
+                                while ( ! go.load() ) {
+                                    std::this_thread::yield();
+                                }
+                                auto fn = [&mtx,&counter,rounds](){
+                                    for ( std::size_t j = 0; j < rounds; ++j) {
+                                        {
+                                            std::unique_lock< boost::fibers::mutex > lk( mtx);
+                                            ++counter;
+                                            busy( std::chrono::nanoseconds( HOLD) );
+                                        }
+                                        busy( std::chrono::nanoseconds( HOLD) );
+                                    }
+                                };
+                                boost::fibers::fiber f1( fn);
+                                boost::fibers::fiber f2( fn);
+                                f1.join();
+                                f2.join();
+                                remote += boost::fibers::context::active()->get_scheduler()->stats().remote_wakeups;
+                              });
+    }
+    time_point_type start( clock_type::now() );
+    go = true;
+    for ( std::thread & t : threads) {
+        t.join();
+    }
+    duration_type total = clock_type::now() - start;
+    if ( rounds * 2 * n != counter) {
+        throw std::runtime_error("lost update");
+    }
+    wakeups = remote;
+    return total / ( rounds * 2 * n);
+}
+
+template< typename ... Args >
+void run( std::string const& name, Args && ... args) {
+    for ( std::size_t n = 1; n <= MAX_THREADS; n *= 2) {
+        boost::fibers::mutex mtx{ args ... };
+        std::uint64_t wakeups = 0;
+        boost::uint64_t res = measure( mtx, n, wakeups).count();
+        std::cout << name << ", " << n << " threads: average of " << res << " nano seconds per lock, "
+                  << wakeups << " remote wakeups" << std::endl;
+    }
+}
+
+int main( int argc, char * argv[])
+{
+    try
+    {
+        run( "mutex");
+        run( "adaptive mutex", boost::fibers::adaptive_spin);
+
+        return EXIT_SUCCESS;
+    }
+    catch ( std::exception const& e)
+    { std::cerr << "exception: " << e.what() << std::endl; }
+    catch (...)
+    { std::cerr << "unhandled exception" << std::endl; }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,137 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// compares fibers::mutex with fibers::shared_mutex (writer-preferring and
+// phase-fair) on a read-mostly workload:
+// N threads run two fibers each, every fiber repeatedly enters a short
+// critical section (HOLD nano seconds); READ_PERCENT of the accesses
+// are reads, taken shared if the mutex supports it
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/fiber/all.hpp>
+
+#include "../clock.hpp"
+
+#ifndef ROUNDS
+#define ROUNDS 100000
+#endif
+
+#ifndef MAX_THREADS
+#define MAX_THREADS 8
+#endif
+
+#ifndef HOLD
+#define HOLD 200
+#endif
+
+void busy( std::chrono::nanoseconds ns) {
+    time_point_type end = clock_type::now() + ns;
+    while ( clock_type::now() < end) {
+    }
+}
+
+void read_lock( boost::fibers::mutex & mtx) {
+    mtx.lock();
+}
+
+void read_unlock( boost::fibers::mutex & mtx) {
+    mtx.unlock();
+}
+
+void read_lock( boost::fibers::shared_mutex & mtx) {
+    mtx.lock_shared();
+}
+
+void read_unlock( boost::fibers::shared_mutex & mtx) {
+    mtx.unlock_shared();
+}
+
+template< typename Mtx >
+duration_type measure( Mtx & mtx, std::size_t n, std::size_t read_percent) {
+    std::atomic< bool > go{ false };
+    std::size_t value1 = 0, value2 = 0;
+    std::atomic< std::size_t > torn{ 0 };
+    std::size_t rounds = ROUNDS / ( 2 * n);
+    std::vector< std::thread > threads;
+    for ( std::size_t i = 0; i < n; ++i) {
+        threads.emplace_back( [&mtx,&go,&value1,&value2,&torn,rounds,read_percent](){
+                                while ( ! go.load() ) {
+                                    std::this_thread::yield();
+                                }
+                                auto fn = [&mtx,&value1,&value2,&torn,rounds,read_percent](){
+                                    for ( std::size_t j = 0; j < rounds; ++j) {
+                                        if ( j % 100 < read_percent) {
+                                            read_lock( mtx);
+                                            if ( value1 != value2) {
+                                                ++torn;
+                                            }
+                                            busy( std::chrono::nanoseconds( HOLD) );
+                                            read_unlock( mtx);
+                                        } else {
+                                            mtx.lock();
+                                            ++value1;
+                                            busy( std::chrono::nanoseconds( HOLD) );
+                                            ++value2;
+                                            mtx.unlock();
+                                        }
+                                        busy( std::chrono::nanoseconds( HOLD) );
+                                    }
+                                };
+                                boost::fibers::fiber f1( fn);
+                                boost::fibers::fiber f2( fn);
+                                f1.join();
+                                f2.join();
+                              });
+    }
+    time_point_type start( clock_type::now() );
+    go = true;
+    for ( std::thread & t : threads) {
+        t.join();
+    }
+    duration_type total = clock_type::now() - start;
+    if ( 0 != torn || value1 != value2) {
+        throw std::runtime_error("torn read");
+    }
+    return total / ( rounds * 2 * n);
+}
+
+template< typename Mtx, typename ... Args >
+void run( std::string const& name, std::size_t read_percent, Args && ... args) {
+    for ( std::size_t n = 1; n <= MAX_THREADS; n *= 2) {
+        Mtx mtx{ args ... };
+        boost::uint64_t res = measure( mtx, n, read_percent).count();
+        std::cout << name << ", " << read_percent << "% reads, " << n << " threads: average of "
+                  << res << " nano seconds per access" << std::endl;
+    }
+}
+
+int main( int argc, char * argv[])
+{
+    try
+    {
+        std::size_t ratios[] = { 50, 90, 99 };
+        for ( std::size_t read_percent : ratios) {
+            run< boost::fibers::mutex >( "mutex", read_percent);
+            run< boost::fibers::shared_mutex >( "shared_mutex", read_percent);
+            run< boost::fibers::shared_mutex >( "phase-fair shared_mutex", read_percent, boost::fibers::phase_fair);
+        }
+
+        return EXIT_SUCCESS;
+    }
+    catch ( std::exception const& e)
+    { std::cerr << "exception: " << e.what() << std::endl; }
+    catch (...)
+    { std::cerr << "unhandled exception" << std::endl; }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,88 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// compares the spinlock variants guarding the wait-queues:
+// N threads repeatedly acquire the same lock and execute a short
+// critical section
+// FIFO locks (ticket, mcs) degrade if the threads outnumber the CPUs:
+// a preempted waiter blocks all waiters queued behind it
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/fiber/detail/spinlock.hpp>
+
+#include "../clock.hpp"
+
+#ifndef ROUNDS
+#define ROUNDS 100000
+#endif
+
+#ifndef MAX_THREADS
+#define MAX_THREADS 64
+#endif
+
+template< typename Lock >
+duration_type measure( std::size_t n) {
+    Lock lk;
+    std::atomic< bool > go{ false };
+    std::size_t counter = 0;
+    std::size_t rounds = ROUNDS / n;
+    std::vector< std::thread > threads;
+    for ( std::size_t i = 0; i < n; ++i) {
+        threads.emplace_back( [&lk,&go,&counter,rounds](){
+                                while ( ! go.load() ) {
+                                    std::this_thread::yield();
+                                }
+                                for ( std::size_t j = 0; j < rounds; ++j) {
+                                    std::unique_lock< Lock > guard( lk);
+                                    ++counter;
+                                }
+                              });
+    }
+    time_point_type start( clock_type::now() );
+    go = true;
+    for ( std::thread & t : threads) {
+        t.join();
+    }
+    duration_type total = clock_type::now() - start;
+    if ( rounds * n != counter) {
+        throw std::runtime_error("lost update");
+    }
+    return total / ( rounds * n);
+}
+
+template< typename Lock >
+void run( std::string const& name) {
+    for ( std::size_t n = 2; n <= MAX_THREADS; n *= 2) {
+        boost::uint64_t res = measure< Lock >( n).count();
+        std::cout << name << ", " << n << " threads: average of " << res << " nano seconds per lock" << std::endl;
+    }
+}
+
+int main( int argc, char * argv[])
+{
+    try
+    {
+        run< boost::fibers::detail::atomic_spinlock >( "ttas");
+        run< boost::fibers::detail::ticket_spinlock >( "ticket");
+        run< boost::fibers::detail::mcs_spinlock >( "mcs");
+        run< std::mutex >( "std::mutex");
+
+        return EXIT_SUCCESS;
+    }
+    catch ( std::exception const& e)
+    { std::cerr << "exception: " << e.what() << std::endl; }
+    catch (...)
+    { std::cerr << "unhandled exception" << std::endl; }
+    return EXIT_FAILURE;
+}
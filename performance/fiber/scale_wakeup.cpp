@@ -0,0 +1,91 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// measures cross-thread wakeups (scheduler::set_remote_ready())
+// N producer threads ping-pong with N fibers running in the
+// main thread; all producers signal the same scheduler
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/fiber/all.hpp>
+
+#include "../clock.hpp"
+
+#ifndef ROUNDS
+#define ROUNDS 100000
+#endif
+
+typedef boost::fibers::unbounded_channel< int > channel_t;
+
+struct pair_t {
+    channel_t   request{};
+    channel_t   response{};
+};
+
+void server( pair_t & p) {
+    int value = 0;
+    while ( boost::fibers::channel_op_status::success == p.request.pop( value) ) {
+        p.response.push( value);
+    }
+}
+
+void producer( pair_t & p) {
+    boost::fibers::fiber( [&p](){
+                            for ( int i = 0; i < ROUNDS; ++i) {
+                                p.request.push( i);
+                                p.response.value_pop();
+                            }
+                            p.request.close();
+                          }).join();
+}
+
+duration_type measure( std::size_t producers) {
+    std::vector< std::unique_ptr< pair_t > > pairs;
+    std::vector< boost::fibers::fiber > servers;
+    for ( std::size_t i = 0; i < producers; ++i) {
+        pairs.emplace_back( new pair_t() );
+        servers.emplace_back( server, std::ref( * pairs.back() ) );
+    }
+    time_point_type start( clock_type::now() );
+    std::vector< std::thread > threads;
+    for ( std::size_t i = 0; i < producers; ++i) {
+        threads.emplace_back( producer, std::ref( * pairs[i]) );
+    }
+    for ( boost::fibers::fiber & f : servers) {
+        f.join();
+    }
+    duration_type total = clock_type::now() - start;
+    for ( std::thread & t : threads) {
+        t.join();
+    }
+    // two remote wakeups per round
+    return total / ( 2 * ROUNDS * producers);
+}
+
+int main( int argc, char * argv[])
+{
+    try
+    {
+        std::size_t max_producers = std::max( 4u, std::thread::hardware_concurrency() );
+        for ( std::size_t producers = 1; producers <= max_producers; producers *= 2) {
+            boost::uint64_t res = measure( producers).count();
+            std::cout << producers << " producer(s): average of " << res << " nano seconds per wakeup" << std::endl;
+        }
+
+        return EXIT_SUCCESS;
+    }
+    catch ( std::exception const& e)
+    { std::cerr << "exception: " << e.what() << std::endl; }
+    catch (...)
+    { std::cerr << "unhandled exception" << std::endl; }
+    return EXIT_FAILURE;
+}
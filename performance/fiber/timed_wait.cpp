@@ -0,0 +1,85 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// measures the sleep-queue (timed waits which are canceled before
+// the deadline is reached): N fibers block in
+// condition_variable::wait_for() with random timeouts,
+// a notifier fiber wakes all of them
+// build with BOOST_FIBERS_USE_TIMER_WHEEL to measure the timer-wheel
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/fiber/all.hpp>
+
+#include "../clock.hpp"
+
+#ifndef ROUNDS
+#define ROUNDS 10
+#endif
+
+#ifndef MAX_FIBERS
+#define MAX_FIBERS 10000
+#endif
+
+duration_type measure( std::size_t n) {
+    boost::fibers::mutex mtx;
+    boost::fibers::condition_variable cond;
+    std::size_t waiting = 0;
+    std::minstd_rand generator( 42);
+    std::uniform_int_distribution< int > distribution( 1, 3600);
+    std::vector< boost::fibers::fiber > fibers;
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < n; ++i) {
+        std::chrono::seconds timeout( distribution( generator) );
+        fibers.emplace_back( [&mtx,&cond,&waiting,timeout](){
+                                for ( int j = 0; j < ROUNDS; ++j) {
+                                    std::unique_lock< boost::fibers::mutex > lk( mtx);
+                                    ++waiting;
+                                    cond.wait_for( lk, timeout);
+                                }
+                             });
+    }
+    boost::fibers::fiber notifier( [&mtx,&cond,&waiting,n](){
+                                    for ( int j = 0; j < ROUNDS; ++j) {
+                                        while ( n != waiting) {
+                                            boost::this_fiber::yield();
+                                        }
+                                        std::unique_lock< boost::fibers::mutex > lk( mtx);
+                                        waiting = 0;
+                                        cond.notify_all();
+                                    }
+                                   });
+    notifier.join();
+    for ( boost::fibers::fiber & f : fibers) {
+        f.join();
+    }
+    duration_type total = clock_type::now() - start;
+    return total / ( ROUNDS * n);
+}
+
+int main( int argc, char * argv[])
+{
+    try
+    {
+        for ( std::size_t n = 100; n <= MAX_FIBERS; n *= 10) {
+            boost::uint64_t res = measure( n).count();
+            std::cout << n << " fibers: average of " << res << " nano seconds per timed wait" << std::endl;
+        }
+
+        return EXIT_SUCCESS;
+    }
+    catch ( std::exception const& e)
+    { std::cerr << "exception: " << e.what() << std::endl; }
+    catch (...)
+    { std::cerr << "unhandled exception" << std::endl; }
+    return EXIT_FAILURE;
+}
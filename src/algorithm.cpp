@@ -15,6 +15,15 @@
 namespace boost {
 namespace fibers {
 
+void
+sched_algorithm::awakened_batch( ready_queue_type & batch) noexcept {
+    while ( ! batch.empty() ) {
+        context * ctx = & batch.front();
+        batch.pop_front();
+        awakened( ctx);
+    }
+}
+
 //static
 fiber_properties *
 sched_algorithm_with_properties_base::get_properties( context * ctx) noexcept {
@@ -27,6 +36,12 @@ sched_algorithm_with_properties_base::set_properties( context * ctx, fiber_prope
     ctx->set_properties( props);
 }
 
+//static
+void *
+sched_algorithm_with_properties_base::get_properties_storage( context * ctx, std::size_t size, std::size_t alignment) noexcept {
+    return ctx->get_properties_storage( size, alignment);
+}
+
 }}
 
 #ifdef BOOST_HAS_ABI_HEADERS
@@ -7,6 +7,7 @@
 #include "boost/fiber/condition_variable.hpp"
 
 #include "boost/fiber/context.hpp"
+#include "boost/fiber/scheduler.hpp"
 
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
@@ -24,20 +25,31 @@ condition_variable_any::notify_one() noexcept {
     }
     context * ctx = & wait_queue_.front();
     wait_queue_.pop_front();
+    lk.unlock();
     // notify context
-    context::active()->set_ready( ctx);
+    context::active()->handoff( ctx);
 }
 
 void
 condition_variable_any::notify_all() noexcept {
+    scheduler * sched = context::active()->get_scheduler();
+    // context' managed by the scheduler of this thread are
+    // passed to the scheduling algorithm at once
+    scheduler::ready_queue_t batch;
     // get all context' from wait-queue
     detail::spinlock_lock lk( wait_queue_splk_);
     // notify all context'
     while ( ! wait_queue_.empty() ) {
         context * ctx = & wait_queue_.front();
         wait_queue_.pop_front();
-        context::active()->set_ready( ctx);
+        if ( sched == ctx->get_scheduler() ) {
+            sched->set_ready( ctx, batch);
+        } else {
+            ctx->get_scheduler()->set_remote_ready( ctx);
+        }
     }
+    lk.unlock();
+    sched->set_ready( batch);
 }
 
 }}
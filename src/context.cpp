@@ -6,13 +6,25 @@
 
 #include "boost/fiber/context.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <new>
+#include <utility>
+
+#include <boost/context/stack_traits.hpp>
 
 #include "boost/fiber/exceptions.hpp"
+#include "boost/fiber/fiber_pool.hpp"
 #include "boost/fiber/interruption.hpp"
 #include "boost/fiber/scheduler.hpp"
 
+#if defined(__linux__)
+extern "C" {
+#include <sys/mman.h>
+}
+#endif
+
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
 #endif
@@ -30,11 +42,13 @@ static intrusive_ptr< context > make_dispatcher_context( scheduler * sched) {
     default_stack salloc; // use default satck-size
     boost::context::stack_context sctx = salloc.allocate();
 #if defined(BOOST_NO_CXX14_CONSTEXPR) || defined(BOOST_NO_CXX11_STD_ALIGN)
-    // reserve space for control structure
-    const std::size_t size = sctx.size - sizeof( context);
-    void * sp = static_cast< char * >( sctx.sp) - sizeof( context);
+    // reserve space for control structure, align sp pointer by hand
+    void * sp = reinterpret_cast< void * >(
+            ( reinterpret_cast< std::uintptr_t >( sctx.sp) - sizeof( context) ) &
+            ~ static_cast< std::uintptr_t >( alignof( context) - 1) );
+    const std::size_t size = sctx.size - ( static_cast< char * >( sctx.sp) - static_cast< char * >( sp) );
 #else
-    constexpr std::size_t func_alignment = 64; // alignof( context);
+    constexpr std::size_t func_alignment = alignof( context);
     constexpr std::size_t func_size = sizeof( context);
     // reserve space on stack
     void * sp = static_cast< char * >( sctx.sp) - func_size - func_alignment;
@@ -61,16 +75,26 @@ thread_local static std::size_t counter;
 context_initializer::context_initializer() {
     if ( 0 == counter++) {
 # if defined(BOOST_NO_CXX14_CONSTEXPR) || defined(BOOST_NO_CXX11_STD_ALIGN)
-        // allocate memory for main context and scheduler
-        constexpr std::size_t size = sizeof( context) + sizeof( scheduler);
+        constexpr std::uintptr_t alignment = BOOST_FIBERS_CACHELINE_LENGTH;
+        constexpr std::size_t ctx_size = sizeof( context);
+        constexpr std::size_t sched_size = sizeof( scheduler);
+        constexpr std::size_t size = 2 * alignment + ctx_size + sched_size;
         void * vp = std::malloc( size);
         if ( nullptr == vp) {
             throw std::bad_alloc();
         }
+        // reserve space for shift, align context pointer by hand
+        char * vp1 = reinterpret_cast< char * >(
+                ( reinterpret_cast< std::uintptr_t >( vp) + sizeof( int) + alignment - 1) & ~ ( alignment - 1) );
+        // store shifted size in front of context
+        * reinterpret_cast< int * >( vp1 - sizeof( int) ) = vp1 - static_cast< char * >( vp);
         // main fiber context of this thread
-        context * main_ctx = ::new ( vp) context( main_context);
+        context * main_ctx = ::new ( vp1) context( main_context);
+        // align scheduler pointer
+        vp1 = reinterpret_cast< char * >(
+                ( reinterpret_cast< std::uintptr_t >( vp1) + ctx_size + alignment - 1) & ~ ( alignment - 1) );
         // scheduler of this thread
-        scheduler * sched = ::new ( static_cast< char * >( vp) + sizeof( context) ) scheduler();
+        scheduler * sched = ::new ( vp1) scheduler();
         // attach main context to scheduler
         sched->attach_main_context( main_ctx);
         // create and attach dispatcher context to scheduler
@@ -79,7 +103,7 @@ context_initializer::context_initializer() {
         // make main context to active context
         context::active_ = main_ctx;
 # else
-        constexpr std::size_t alignment = 64; // alignof( capture_t);
+        constexpr std::size_t alignment = BOOST_FIBERS_CACHELINE_LENGTH;
         constexpr std::size_t ctx_size = sizeof( context);
         constexpr std::size_t sched_size = sizeof( scheduler);
         constexpr std::size_t size = 2 * alignment + ctx_size + sched_size;
@@ -122,13 +146,9 @@ context_initializer::~context_initializer() {
         scheduler * sched = main_ctx->get_scheduler();
         sched->~scheduler();
         main_ctx->~context();
-# if defined(BOOST_NO_CXX14_CONSTEXPR) || defined(BOOST_NO_CXX11_STD_ALIGN)
-        std::free( main_ctx);
-# else
         int * shift = reinterpret_cast< int * >( reinterpret_cast< char * >( main_ctx) - sizeof( int) );
         void * vp = reinterpret_cast< char * >( main_ctx) - ( * shift);
         std::free( vp);
-# endif
     }
 }
 
@@ -161,17 +181,46 @@ context::set_ready_( context * ctx) noexcept {
     scheduler_->set_ready( ctx);
 }
 
+void
+context::run_pooled_( data_t * dp) noexcept {
+    if ( nullptr != dp->lk) {
+        dp->lk->unlock();
+    } else if ( nullptr != dp->ctx) {
+        active_->set_ready_( dp->ctx);
+    }
+    for (;;) {
+        BOOST_ASSERT( nullptr != task_);
+        try {
+            task_->run();
+        } catch ( fiber_interrupted const&) {
+        }
+        // destroy the function before the fiber terminates
+        detail::pool_task * task = nullptr;
+        std::swap( task, task_);
+        task->destroy();
+        // terminate context
+        terminate();
+        // context was recycled by its pool and
+        // resumed with a new task
+    }
+}
+
+void
+context::release_() noexcept {
+    BOOST_ASSERT( nullptr != pool_);
+    pool_->recycle( this);
+}
+
 // main fiber context
 context::context( main_context_t) noexcept :
     use_count_{ 1 }, // allocated on main- or thread-stack
-    flags_{ flag_main_context },
-    ctx_{ boost::context::execution_context::current() } {
+    ctx_{ boost::context::execution_context::current() },
+    flags_{ flag_main_context } {
 }
 
 // dispatcher fiber context
 context::context( dispatcher_context_t, boost::context::preallocated const& palloc,
                   default_stack const& salloc, scheduler * sched) :
-    flags_{ flag_dispatcher_context },
     ctx_{ std::allocator_arg, palloc, salloc,
           [this,sched] (void * vp) noexcept {
             data_t * dp = static_cast< data_t * >( vp);
@@ -184,7 +233,9 @@ context::context( dispatcher_context_t, boost::context::preallocated const& pall
             sched->dispatch();
             // dispatcher context should never return from scheduler::dispatch()
             BOOST_ASSERT_MSG( false, "disatcher fiber already terminated");
-          }} {
+          }},
+    sctx_{ palloc.sctx },
+    flags_{ flag_dispatcher_context } {
 }
 
 context::~context() {
@@ -192,7 +243,10 @@ context::~context() {
     BOOST_ASSERT( ! ready_is_linked() );
     BOOST_ASSERT( ! sleep_is_linked() );
     BOOST_ASSERT( ! wait_is_linked() );
-    delete properties_;
+    set_properties( nullptr);
+    if ( nullptr != pool_) {
+        intrusive_ptr_release( pool_);
+    }
 }
 
 scheduler *
@@ -295,8 +349,19 @@ context::terminate() noexcept {
     }
     lk.unlock();
     // release fiber-specific-data
-    for ( fss_data_t::value_type & data : fss_data_) {
-        data.second.do_cleanup();
+    for ( fss_data & data : fss_inline_) {
+        fss_data tmp;
+        std::swap( tmp, data);
+        if ( nullptr != tmp.vp) {
+            tmp.do_cleanup();
+        }
+    }
+    for ( std::size_t i = 0; i < fss_data_.size(); ++i) {
+        fss_data tmp;
+        std::swap( tmp, fss_data_[i]);
+        if ( nullptr != tmp.vp) {
+            tmp.do_cleanup();
+        }
     }
     fss_data_.clear();
     // switch to another context
@@ -336,6 +401,28 @@ context::set_ready( context * ctx) noexcept {
     }
 }
 
+void
+context::handoff( context * ctx) noexcept {
+    BOOST_ASSERT( nullptr != ctx);
+    BOOST_ASSERT( this == active_);
+    BOOST_ASSERT( this != ctx);
+    BOOST_ASSERT( nullptr != scheduler_);
+    // switch directly to ctx only if it belongs to this scheduler
+    // and is not already stored in any ready-queue
+    // (e.g. signaled by interruption)
+    // this fiber must not be suspended while it holds a spinlock
+    if ( scheduler_ == ctx->scheduler_ &&
+         scheduler_->handoff_enabled() &&
+         ! handoff_blocked() &&
+         ! ctx->ready_is_linked() &&
+         ! ctx->remote_ready_is_linked() &&
+         ! ctx->is_queued() ) {
+        scheduler_->handoff( this, ctx);
+    } else {
+        set_ready( ctx);
+    }
+}
+
 void
 context::interruption_blocked( bool blck) noexcept {
     if ( blck) {
@@ -345,6 +432,15 @@ context::interruption_blocked( bool blck) noexcept {
     }
 }
 
+void
+context::handoff_blocked( bool blck) noexcept {
+    if ( blck) {
+        flags_ |= flag_handoff_blocked;
+    } else {
+        flags_ &= ~flag_handoff_blocked;
+    }
+}
+
 void
 context::request_interruption( bool req) noexcept {
     BOOST_ASSERT( ! is_main_context() && ! is_dispatcher_context() );
@@ -355,48 +451,128 @@ context::request_interruption( bool req) noexcept {
     }
 }
 
-void *
-context::get_fss_data( void const * vp) const {
-    uintptr_t key( reinterpret_cast< uintptr_t >( vp) );
-    fss_data_t::const_iterator i( fss_data_.find( key) );
-    return fss_data_.end() != i ? i->second.vp : nullptr;
+bool
+context::queued_mark() noexcept {
+#if ! defined(BOOST_FIBERS_NO_ATOMICS)
+    return 0 == ( flags_.fetch_or( flag_queued) & flag_queued);
+#else
+    if ( 0 != ( flags_ & flag_queued) ) {
+        return false;
+    }
+    flags_ |= flag_queued;
+    return true;
+#endif
 }
 
 void
-context::set_fss_data( void const * vp,
+context::queued_unmark() noexcept {
+    flags_ &= ~flag_queued;
+}
+
+void
+context::set_fss_data( std::size_t key,
                        detail::fss_cleanup_function::ptr_t const& cleanup_fn,
                        void * data,
                        bool cleanup_existing) {
     BOOST_ASSERT( cleanup_fn);
-    uintptr_t key( reinterpret_cast< uintptr_t >( vp) );
-    fss_data_t::iterator i( fss_data_.find( key) );
-    if ( fss_data_.end() != i) {
-        if( cleanup_existing) {
-            i->second.do_cleanup();
-        }
-        if ( nullptr != data) {
-            fss_data_.insert(
-                    i,
-                    std::make_pair(
-                        key,
-                        fss_data( data, cleanup_fn) ) );
-        } else {
-            fss_data_.erase( i);
-        }
+    fss_data * slot = nullptr;
+    if ( BOOST_FIBERS_FSS_INLINE_SLOTS > key) {
+        slot = & fss_inline_[key];
     } else {
-        fss_data_.insert(
-            std::make_pair(
-                key,
-                fss_data( data, cleanup_fn) ) );
+        std::size_t idx = key - BOOST_FIBERS_FSS_INLINE_SLOTS;
+        if ( fss_data_.size() <= idx) {
+            if ( nullptr == data) {
+                // nothing stored
+                return;
+            }
+            fss_data_.resize( idx + 1);
+        }
+        slot = & fss_data_[idx];
+    }
+    fss_data tmp;
+    std::swap( tmp, * slot);
+    if ( nullptr != data) {
+        * slot = fss_data( data, cleanup_fn);
+    }
+    // the cleanup function might access the fiber-specific
+    // storage, the slot has been already updated
+    // data left over by a destroyed fiber_specific_ptr are
+    // released too
+    if ( nullptr != tmp.vp && ( cleanup_existing || tmp.cleanup_function != cleanup_fn) ) {
+        tmp.do_cleanup();
     }
 }
 
 void
 context::set_properties( fiber_properties * props) noexcept {
-    delete properties_;
+    if ( nullptr != properties_) {
+        if ( dynamic_cast< void * >( properties_) == properties_storage_) {
+            // constructed on the fiber's stack
+            properties_->~fiber_properties();
+        } else {
+            delete properties_;
+        }
+    }
     properties_ = props;
 }
 
+//static
+std::size_t
+context::active_properties_size() noexcept {
+    return active()->get_scheduler()->properties_size();
+}
+
+void *
+context::get_properties_storage( std::size_t size, std::size_t alignment) const noexcept {
+    if ( nullptr == properties_storage_ ||
+         properties_storage_size_ < size ||
+         0 != reinterpret_cast< std::uintptr_t >( properties_storage_) % alignment) {
+        return nullptr;
+    }
+    if ( nullptr != properties_ && dynamic_cast< void * >( properties_) == properties_storage_) {
+        // storage in use
+        return nullptr;
+    }
+    return properties_storage_;
+}
+
+std::size_t
+context::stack_high_watermark() const noexcept {
+#if defined(__linux__)
+    if ( nullptr == sctx_.sp) {
+        return 0;
+    }
+    const std::uintptr_t page_size = boost::context::stack_traits::page_size();
+    const std::uintptr_t top = reinterpret_cast< std::uintptr_t >( sctx_.sp);
+    // mincore() requires a page aligned address, pages only partially
+    // belonging to the stack (stack not allocated by mmap()) are skipped
+    const std::uintptr_t first = ( top - sctx_.size + page_size - 1) & ~( page_size - 1);
+    const std::uintptr_t last = top & ~( page_size - 1);
+    if ( last <= first) {
+        return 0;
+    }
+    // one byte per page, the stack grows downwards: the lowest resident
+    // page marks the deepest extent
+    unsigned char vec[256];
+    for ( std::uintptr_t addr = first; addr < last;) {
+        const std::uintptr_t pages = ( std::min)( ( last - addr) / page_size, static_cast< std::uintptr_t >( sizeof( vec) ) );
+        if ( 0 != ::mincore( reinterpret_cast< void * >( addr), pages * page_size, vec) ) {
+            return 0;
+        }
+        for ( std::uintptr_t i = 0; i < pages; ++i) {
+            if ( 0 != ( vec[i] & 1) ) {
+                return top - ( addr + i * page_size);
+            }
+        }
+        addr += pages * page_size;
+    }
+    // only the top (partial) page has been used
+    return top - last;
+#else
+    return 0;
+#endif
+}
+
 bool
 context::worker_is_linked() const noexcept {
     return worker_hook_.is_linked();
@@ -437,11 +613,6 @@ context::ready_unlink() noexcept {
     ready_hook_.unlink();
 }
 
-void
-context::remote_ready_unlink() noexcept {
-    remote_ready_hook_.unlink();
-}
-
 void
 context::sleep_unlink() noexcept {
     sleep_hook_.unlink();
@@ -0,0 +1,133 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/counting_semaphore.hpp"
+
+#include <system_error>
+
+#include "boost/fiber/exceptions.hpp"
+#include "boost/fiber/scheduler.hpp"
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+counting_semaphore::counting_semaphore( std::ptrdiff_t desired) :
+    count_{ desired } {
+    if ( 0 > desired) {
+        throw fiber_error( std::make_error_code( std::errc::invalid_argument),
+                           "boost fiber: negative initial semaphore count");
+    }
+}
+
+void
+counting_semaphore::release( std::ptrdiff_t update) {
+    if ( 0 > update || max() - count_.load( std::memory_order_relaxed) < update) {
+        throw fiber_error( std::make_error_code( std::errc::invalid_argument),
+                           "boost fiber: invalid semaphore update");
+    }
+    // either acquire() finds the permits or release() finds the waiter:
+    // both sides write one counter and read the other one (seq_cst)
+    count_.fetch_add( update);
+    if ( 0 == update || 0 == waiters_.load() ) {
+        return;
+    }
+    scheduler * sched = context::active()->get_scheduler();
+    // context' managed by the scheduler of this thread are
+    // passed to the scheduling algorithm at once
+    scheduler::ready_queue_t batch;
+    detail::spinlock_lock lk( wait_queue_splk_);
+    // pass one permit to each woken fiber, the permits might
+    // have been taken by try_acquire() in the meantime
+    // the fibers are unlinked while lk is held, a fiber timing
+    // out in try_acquire_until_() owns a permit if it is not linked
+    for ( std::ptrdiff_t n = 0; n < update && ! wait_queue_.empty() && try_acquire(); ++n) {
+        context * ctx = & wait_queue_.front();
+        wait_queue_.pop_front();
+        waiters_.fetch_sub( 1, std::memory_order_relaxed);
+        if ( sched == ctx->get_scheduler() ) {
+            sched->set_ready( ctx, batch);
+        } else {
+            ctx->get_scheduler()->set_remote_ready( ctx);
+        }
+    }
+    // a woken fiber might destroy the semaphore
+    lk.unlock();
+    sched->set_ready( batch);
+}
+
+bool
+counting_semaphore::try_acquire() noexcept {
+    // pairs with waiters_.load() in release()
+    std::ptrdiff_t count = count_.load();
+    do {
+        if ( 0 == count) {
+            return false;
+        }
+    } while ( ! count_.compare_exchange_weak( count, count - 1, std::memory_order_acquire) );
+    return true;
+}
+
+void
+counting_semaphore::acquire() noexcept {
+    if ( try_acquire() ) {
+        return;
+    }
+    context * ctx = context::active();
+    detail::spinlock_lock lk( wait_queue_splk_);
+    waiters_.fetch_add( 1);
+    // permits released before waiters_ was incremented
+    if ( try_acquire() ) {
+        waiters_.fetch_sub( 1, std::memory_order_relaxed);
+        return;
+    }
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    ctx->wait_link( wait_queue_);
+    // suspend this fiber
+    ctx->suspend( lk);
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    // the permit has been passed by release()
+}
+
+bool
+counting_semaphore::try_acquire_until_( std::chrono::steady_clock::time_point const& timeout_time) noexcept {
+    if ( try_acquire() ) {
+        return true;
+    }
+    if ( std::chrono::steady_clock::now() > timeout_time) {
+        return false;
+    }
+    context * ctx = context::active();
+    detail::spinlock_lock lk( wait_queue_splk_);
+    waiters_.fetch_add( 1);
+    if ( try_acquire() ) {
+        waiters_.fetch_sub( 1, std::memory_order_relaxed);
+        return true;
+    }
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    ctx->wait_link( wait_queue_);
+    // suspend this fiber until notified or timed-out
+    if ( ! ctx->wait_until( timeout_time, lk) ) {
+        lk.lock();
+        // release() might have passed a permit
+        // before the timeout was processed
+        if ( ctx->wait_is_linked() ) {
+            ctx->wait_unlink();
+            waiters_.fetch_sub( 1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    return true;
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
@@ -0,0 +1,74 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/detail/fss.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+namespace {
+
+// keys are created and deleted together with fiber_specific_ptr,
+// not on the path accessing fiber-specific data
+class fss_keys {
+private:
+    std::mutex                  mtx_{};
+    std::size_t                 next_{ 0 };
+    // keys of destroyed fiber_specific_ptr
+    std::vector< std::size_t >  free_{};
+
+public:
+    std::size_t create() {
+        std::unique_lock< std::mutex > lk( mtx_);
+        if ( free_.empty() ) {
+            return next_++;
+        }
+        // reuse the lowest slots first, keeps the slot arrays small
+        std::vector< std::size_t >::iterator i = std::min_element( free_.begin(), free_.end() );
+        std::size_t key = * i;
+        * i = free_.back();
+        free_.pop_back();
+        return key;
+    }
+
+    void remove( std::size_t key) noexcept {
+        std::unique_lock< std::mutex > lk( mtx_);
+        try {
+            free_.push_back( key);
+        } catch (...) {
+            // key is leaked
+        }
+    }
+};
+
+fss_keys & keys() {
+    static fss_keys k;
+    return k;
+}
+
+}
+
+std::size_t fss_key_create() {
+    return keys().create();
+}
+
+void fss_key_delete( std::size_t key) noexcept {
+    keys().remove( key);
+}
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
@@ -0,0 +1,163 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/detail/mutex_impl.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "boost/fiber/detail/cpu_relax.hpp"
+#include "boost/fiber/scheduler.hpp"
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+constexpr std::uintptr_t mutex_impl::waiters_bit;
+
+// lk is held and the waiters-bit is set on entry: the owner can not
+// release the mutex (and terminate) before lk is unlocked
+// returns true if the mutex has been acquired (lk is unlocked),
+// otherwise lk is held on return
+bool
+mutex_impl::spin_( context * ctx, spinlock_lock & lk) noexcept {
+    // on a uniprocessor the owner can not run while this thread spins
+    static const bool smp = 1 < std::thread::hardware_concurrency();
+    if ( ! smp) {
+        return false;
+    }
+    context * owner = this->owner();
+    BOOST_ASSERT( nullptr != owner);
+    scheduler * sched = owner->get_scheduler();
+    if ( sched == ctx->get_scheduler() || ! sched->is_running( owner) ) {
+        // the owner is suspended or waits for this thread,
+        // spinning would not make progress
+        return false;
+    }
+    // budget: twice the recent average (glibc's adaptive mutex)
+    int spins = spins_.load( std::memory_order_relaxed);
+    int budget = (std::min)( BOOST_FIBERS_MUTEX_MAX_SPINS, 2 * spins + 10);
+    int n = 0;
+    bool acquired = false;
+    // the owner releases the mutex in unlock_slow_(), the wait-queue
+    // is empty or other fibers acquire it
+    lk.unlock();
+    while ( n < budget) {
+        ++n;
+        if ( 0 == state_.load( std::memory_order_relaxed) && try_lock( ctx) ) {
+            acquired = true;
+            break;
+        }
+        cpu_relax();
+    }
+    spins_.store( spins + ( n - spins) / 8, std::memory_order_relaxed);
+    if ( ! acquired) {
+        lk.lock();
+    }
+    return acquired;
+}
+
+void
+mutex_impl::lock_slow( context * ctx) noexcept {
+    BOOST_ASSERT( ctx != owner() );
+    spinlock_lock lk( wait_queue_splk_);
+    bool spun = false;
+    for (;;) {
+        std::uintptr_t state = state_.load( std::memory_order_relaxed);
+        if ( 0 == state) {
+            if ( state_.compare_exchange_weak(
+                        state, bits_( ctx), std::memory_order_acquire, std::memory_order_relaxed) ) {
+                return;
+            }
+            continue;
+        }
+        // forces the owner into unlock_slow_()
+        if ( 0 == ( state & waiters_bit) &&
+             ! state_.compare_exchange_weak(
+                    state, state | waiters_bit, std::memory_order_relaxed, std::memory_order_relaxed) ) {
+            continue;
+        }
+        if ( adaptive_ && ! spun) {
+            spun = true;
+            if ( spin_( ctx, lk) ) {
+                return;
+            }
+            continue;
+        }
+        BOOST_ASSERT( ! ctx->wait_is_linked() );
+        ctx->wait_link( wait_queue_);
+        // suspend this fiber
+        ctx->suspend( lk);
+        BOOST_ASSERT( ! ctx->wait_is_linked() );
+        // the ownership has been passed by unlock_slow_()
+        BOOST_ASSERT( ctx == owner() );
+        return;
+    }
+}
+
+bool
+mutex_impl::try_lock_until( context * ctx, std::chrono::steady_clock::time_point const& timeout_time) noexcept {
+    BOOST_ASSERT( ctx != owner() );
+    spinlock_lock lk( wait_queue_splk_);
+    for (;;) {
+        std::uintptr_t state = state_.load( std::memory_order_relaxed);
+        if ( 0 == state) {
+            if ( state_.compare_exchange_weak(
+                        state, bits_( ctx), std::memory_order_acquire, std::memory_order_relaxed) ) {
+                return true;
+            }
+            continue;
+        }
+        if ( 0 == ( state & waiters_bit) &&
+             ! state_.compare_exchange_weak(
+                    state, state | waiters_bit, std::memory_order_relaxed, std::memory_order_relaxed) ) {
+            continue;
+        }
+        BOOST_ASSERT( ! ctx->wait_is_linked() );
+        ctx->wait_link( wait_queue_);
+        // suspend this fiber until notified or timed-out
+        if ( ! ctx->wait_until( timeout_time, lk) ) {
+            lk.lock();
+            // unlock_slow_() might have passed the ownership
+            // before the timeout was processed
+            if ( ctx->wait_is_linked() ) {
+                ctx->wait_unlink();
+                if ( wait_queue_.empty() ) {
+                    state_.fetch_and( ~waiters_bit, std::memory_order_relaxed);
+                }
+                return false;
+            }
+        }
+        BOOST_ASSERT( ! ctx->wait_is_linked() );
+        BOOST_ASSERT( ctx == owner() );
+        return true;
+    }
+}
+
+void
+mutex_impl::unlock_slow_() noexcept {
+    spinlock_lock lk( wait_queue_splk_);
+    if ( wait_queue_.empty() ) {
+        // fibers spinning in spin_() or timed out
+        state_.store( 0, std::memory_order_release);
+        return;
+    }
+    context * ctx = & wait_queue_.front();
+    wait_queue_.pop_front();
+    state_.store( bits_( ctx) | ( wait_queue_.empty() ? 0 : waiters_bit),
+                  std::memory_order_release);
+    lk.unlock();
+    context::active()->handoff( ctx);
+}
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
@@ -0,0 +1,171 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/detail/numa.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+extern "C" {
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+}
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+namespace {
+
+#if defined(__linux__)
+// parses a list of the form "0-3,8,10-11"
+std::vector< std::size_t > parse_list( std::string const& str) {
+    std::vector< std::size_t > result;
+    std::istringstream is( str);
+    std::string range;
+    while ( std::getline( is, range, ',') ) {
+        if ( range.empty() || '\n' == range[0]) {
+            continue;
+        }
+        std::size_t first = std::stoul( range);
+        std::size_t last = first;
+        std::string::size_type pos = range.find( '-');
+        if ( std::string::npos != pos) {
+            last = std::stoul( range.substr( pos + 1) );
+        }
+        for ( std::size_t i = first; i <= last; ++i) {
+            result.push_back( i);
+        }
+    }
+    return result;
+}
+
+std::string read_file( std::string const& path) {
+    std::ifstream is( path);
+    std::string str;
+    std::getline( is, str);
+    return str;
+}
+#endif
+
+class topology {
+private:
+    // node of each CPU, empty if the topology is not known
+    std::vector< std::size_t >  cpu2node_{};
+    std::size_t                 nodes_{ 1 };
+
+public:
+    topology() noexcept {
+#if defined(__linux__)
+        try {
+            std::vector< std::size_t > nodes = parse_list( read_file( "/sys/devices/system/node/online") );
+            for ( std::size_t node : nodes) {
+                std::vector< std::size_t > cpus = parse_list(
+                        read_file( "/sys/devices/system/node/node" + std::to_string( node) + "/cpulist") );
+                for ( std::size_t cpu : cpus) {
+                    if ( cpu2node_.size() <= cpu) {
+                        cpu2node_.resize( cpu + 1, 0);
+                    }
+                    cpu2node_[cpu] = node;
+                }
+                nodes_ = ( std::max)( nodes_, node + 1);
+            }
+        } catch (...) {
+            cpu2node_.clear();
+            nodes_ = 1;
+        }
+#endif
+    }
+
+    std::size_t nodes() const noexcept {
+        return nodes_;
+    }
+
+    std::size_t node_of( std::size_t cpu) const noexcept {
+        return cpu < cpu2node_.size() ? cpu2node_[cpu] : 0;
+    }
+
+    std::vector< std::size_t > cpus_of( std::size_t node) const {
+        std::vector< std::size_t > cpus;
+        if ( cpu2node_.empty() ) {
+            if ( 0 == node) {
+                std::size_t count = ( std::max)( std::thread::hardware_concurrency(), 1u);
+                for ( std::size_t cpu = 0; cpu < count; ++cpu) {
+                    cpus.push_back( cpu);
+                }
+            }
+            return cpus;
+        }
+        for ( std::size_t cpu = 0; cpu < cpu2node_.size(); ++cpu) {
+            if ( node == cpu2node_[cpu]) {
+                cpus.push_back( cpu);
+            }
+        }
+        return cpus;
+    }
+};
+
+topology const& get_topology() noexcept {
+    static topology t;
+    return t;
+}
+
+}
+
+std::size_t numa_node_count() noexcept {
+    return get_topology().nodes();
+}
+
+std::size_t numa_node_of_cpu( std::size_t cpu) noexcept {
+    return get_topology().node_of( cpu);
+}
+
+std::size_t numa_current_node() noexcept {
+#if defined(__linux__)
+    int cpu = ::sched_getcpu();
+    if ( 0 <= cpu) {
+        return get_topology().node_of( static_cast< std::size_t >( cpu) );
+    }
+#endif
+    return 0;
+}
+
+std::vector< std::size_t > numa_node_cpus( std::size_t node) {
+    return get_topology().cpus_of( node);
+}
+
+bool numa_bind( void * vp, std::size_t size, std::size_t node) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+    // MPOL_PREFERRED from <numaif.h>, libnuma is not required
+    constexpr int mpol_preferred = 1;
+    constexpr std::size_t max_nodes = 1024;
+    constexpr std::size_t bits = sizeof( unsigned long) * CHAR_BIT;
+    if ( numa_node_count() <= node || max_nodes <= node) {
+        return false;
+    }
+    unsigned long mask[max_nodes / bits] = {};
+    mask[node / bits] = 1ul << ( node % bits);
+    return 0 == ::syscall( SYS_mbind, vp, size, mpol_preferred, mask, max_nodes + 1, 0);
+#else
+    return false;
+#endif
+}
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
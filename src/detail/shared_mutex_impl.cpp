@@ -0,0 +1,193 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/detail/shared_mutex_impl.hpp"
+
+#include "boost/fiber/scheduler.hpp"
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+// passes the ownership to the first waiting writer
+void
+shared_mutex_impl::wake_writer_( spinlock_lock & lk) noexcept {
+    BOOST_ASSERT( nullptr == writer_.load( std::memory_order_relaxed) );
+    BOOST_ASSERT( 0 == readers_);
+    BOOST_ASSERT( ! writers_queue_.empty() );
+    context * ctx = & writers_queue_.front();
+    writers_queue_.pop_front();
+    writer_.store( ctx, std::memory_order_relaxed);
+    lk.unlock();
+    context::active()->handoff( ctx);
+}
+
+// passes the shared ownership to all waiting readers
+void
+shared_mutex_impl::wake_readers_( spinlock_lock & lk) noexcept {
+    BOOST_ASSERT( nullptr == writer_.load( std::memory_order_relaxed) );
+    scheduler * sched = context::active()->get_scheduler();
+    // context' managed by the scheduler of this thread are
+    // passed to the scheduling algorithm at once
+    scheduler::ready_queue_t batch;
+    while ( ! readers_queue_.empty() ) {
+        context * ctx = & readers_queue_.front();
+        readers_queue_.pop_front();
+        ++readers_;
+        if ( sched == ctx->get_scheduler() ) {
+            sched->set_ready( ctx, batch);
+        } else {
+            ctx->get_scheduler()->set_remote_ready( ctx);
+        }
+    }
+    lk.unlock();
+    sched->set_ready( batch);
+}
+
+void
+shared_mutex_impl::lock( context * ctx) noexcept {
+    BOOST_ASSERT( ctx != owner() );
+    spinlock_lock lk( wait_queue_splk_);
+    if ( nullptr == writer_.load( std::memory_order_relaxed) && 0 == readers_) {
+        writer_.store( ctx, std::memory_order_relaxed);
+        return;
+    }
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    ctx->wait_link( writers_queue_);
+    // suspend this fiber
+    ctx->suspend( lk);
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    // the ownership has been passed by wake_writer_()
+    BOOST_ASSERT( ctx == owner() );
+}
+
+bool
+shared_mutex_impl::try_lock( context * ctx) noexcept {
+    spinlock_lock lk( wait_queue_splk_);
+    if ( nullptr == writer_.load( std::memory_order_relaxed) && 0 == readers_) {
+        writer_.store( ctx, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool
+shared_mutex_impl::try_lock_until( context * ctx, std::chrono::steady_clock::time_point const& timeout_time) noexcept {
+    BOOST_ASSERT( ctx != owner() );
+    spinlock_lock lk( wait_queue_splk_);
+    if ( nullptr == writer_.load( std::memory_order_relaxed) && 0 == readers_) {
+        writer_.store( ctx, std::memory_order_relaxed);
+        return true;
+    }
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    ctx->wait_link( writers_queue_);
+    // suspend this fiber until notified or timed-out
+    if ( ! ctx->wait_until( timeout_time, lk) ) {
+        lk.lock();
+        // the ownership might have been passed
+        // before the timeout was processed
+        if ( ctx->wait_is_linked() ) {
+            ctx->wait_unlink();
+            // readers blocked only by this writer
+            if ( nullptr == writer_.load( std::memory_order_relaxed) &&
+                 writers_queue_.empty() &&
+                 ! readers_queue_.empty() ) {
+                wake_readers_( lk);
+            }
+            return false;
+        }
+    }
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    BOOST_ASSERT( ctx == owner() );
+    return true;
+}
+
+void
+shared_mutex_impl::unlock() noexcept {
+    BOOST_ASSERT( context::active() == owner() );
+    spinlock_lock lk( wait_queue_splk_);
+    writer_.store( nullptr, std::memory_order_relaxed);
+    if ( phase_fair_ && ! readers_queue_.empty() ) {
+        // start a read phase, even if writers are waiting
+        wake_readers_( lk);
+    } else if ( ! writers_queue_.empty() ) {
+        wake_writer_( lk);
+    } else if ( ! readers_queue_.empty() ) {
+        wake_readers_( lk);
+    }
+}
+
+void
+shared_mutex_impl::lock_shared( context * ctx) noexcept {
+    BOOST_ASSERT( ctx != owner() );
+    spinlock_lock lk( wait_queue_splk_);
+    if ( nullptr == writer_.load( std::memory_order_relaxed) && writers_queue_.empty() ) {
+        ++readers_;
+        return;
+    }
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    ctx->wait_link( readers_queue_);
+    // suspend this fiber
+    ctx->suspend( lk);
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+}
+
+bool
+shared_mutex_impl::try_lock_shared() noexcept {
+    spinlock_lock lk( wait_queue_splk_);
+    if ( nullptr == writer_.load( std::memory_order_relaxed) && writers_queue_.empty() ) {
+        ++readers_;
+        return true;
+    }
+    return false;
+}
+
+bool
+shared_mutex_impl::try_lock_shared_until( context * ctx, std::chrono::steady_clock::time_point const& timeout_time) noexcept {
+    BOOST_ASSERT( ctx != owner() );
+    spinlock_lock lk( wait_queue_splk_);
+    if ( nullptr == writer_.load( std::memory_order_relaxed) && writers_queue_.empty() ) {
+        ++readers_;
+        return true;
+    }
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    ctx->wait_link( readers_queue_);
+    // suspend this fiber until notified or timed-out
+    if ( ! ctx->wait_until( timeout_time, lk) ) {
+        lk.lock();
+        // the shared ownership might have been passed
+        // before the timeout was processed
+        if ( ctx->wait_is_linked() ) {
+            ctx->wait_unlink();
+            return false;
+        }
+    }
+    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    return true;
+}
+
+bool
+shared_mutex_impl::unlock_shared() noexcept {
+    spinlock_lock lk( wait_queue_splk_);
+    if ( 0 == readers_) {
+        return false;
+    }
+    // fibers waiting in readers_queue_ are blocked by
+    // a waiting writer
+    if ( 0 == --readers_ && ! writers_queue_.empty() ) {
+        wake_writer_( lk);
+    }
+    return true;
+}
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
@@ -1,4 +1,3 @@
-
 //          Copyright Oliver Kowalke 2013.
 // Distributed under the Boost Software License, Version 1.0.
 //    (See accompanying file LICENSE_1_0.txt or copy at
@@ -6,29 +5,57 @@
 
 #include "boost/fiber/detail/spinlock.hpp"
 
+#include <algorithm>
 #include <thread>
 
 #include <boost/assert.hpp>
 
+#include "boost/fiber/detail/cpu_relax.hpp"
 #include "boost/fiber/scheduler.hpp"
 
 namespace boost {
 namespace fibers {
 namespace detail {
 
+namespace {
+
+// busy-waits with exponentially growing pauses,
+// yields the time slice once the spin budget is exhausted
+class backoff {
+private:
+    std::size_t     tests_{ 0 };
+    std::size_t     pauses_{ 1 };
+
+public:
+    void operator()() noexcept {
+        if ( BOOST_FIBERS_SPIN_MAX_TESTS > tests_) {
+            ++tests_;
+            for ( std::size_t i = 0; i < pauses_; ++i) {
+                cpu_relax();
+            }
+            pauses_ = ( std::min)( pauses_ * 2, static_cast< std::size_t >( BOOST_FIBERS_SPIN_MAX_BACKOFF) );
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+}
+
 void
 atomic_spinlock::lock() noexcept {
+    backoff b;
     do {
         // access to CPU's cache
         // first access to state_ -> cache miss
         // sucessive acccess to state_ -> cache hit
         while ( spinlock_status::locked == state_.load( std::memory_order_relaxed) ) {
             // busy-wait
-            std::this_thread::yield();
+            b();
         }
         // state_ was released by other fiber
         // cached copies are invalidated -> cache miss
-        // test-and-set signaled over the bus 
+        // test-and-set signaled over the bus
     }
     while ( spinlock_status::unlocked != state_.exchange( spinlock_status::locked, std::memory_order_acquire) );
 }
@@ -39,4 +66,93 @@ atomic_spinlock::unlock() noexcept {
     state_.store( spinlock_status::unlocked, std::memory_order_release);
 }
 
+void
+ticket_spinlock::lock() noexcept {
+    std::size_t ticket = next_ticket_.fetch_add( 1, std::memory_order_relaxed);
+    std::size_t tests = 0;
+    for (;;) {
+        std::size_t serving = now_serving_.load( std::memory_order_acquire);
+        if ( ticket == serving) {
+            return;
+        }
+        if ( BOOST_FIBERS_SPIN_MAX_TESTS > tests) {
+            ++tests;
+            // proportional backoff: each waiter ahead holds the lock
+            // for a short critical section
+            std::size_t pauses = ( std::min)( ( ticket - serving) * 16, static_cast< std::size_t >( BOOST_FIBERS_SPIN_MAX_BACKOFF) );
+            for ( std::size_t i = 0; i < pauses; ++i) {
+                cpu_relax();
+            }
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void
+ticket_spinlock::unlock() noexcept {
+    BOOST_ASSERT( next_ticket_.load() != now_serving_.load() );
+    // only the holder modifies now_serving_
+    now_serving_.store( now_serving_.load( std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void
+mcs_spinlock::lock() noexcept {
+    for (;;) {
+        node * prev = q_.tail.load( std::memory_order_acquire);
+        if ( nullptr == prev) {
+            // lock is free
+            if ( q_.tail.compare_exchange_strong( prev, & q_, std::memory_order_acquire) ) {
+                return;
+            }
+        } else {
+            // tail of a waiter signals that it is still waiting
+            node n;
+            n.tail.store( & n, std::memory_order_relaxed);
+            if ( q_.tail.compare_exchange_strong( prev, & n, std::memory_order_acq_rel) ) {
+                prev->next.store( & n, std::memory_order_release);
+                backoff b;
+                while ( nullptr != n.tail.load( std::memory_order_acquire) ) {
+                    b();
+                }
+                // lock acquired, n goes out of scope: move the successor
+                // (if any) to q_
+                node * succ = n.next.load( std::memory_order_acquire);
+                if ( nullptr == succ) {
+                    q_.next.store( nullptr, std::memory_order_relaxed);
+                    node * expected = & n;
+                    if ( ! q_.tail.compare_exchange_strong( expected, & q_, std::memory_order_acq_rel) ) {
+                        // a new waiter is linking itself to n
+                        while ( nullptr == ( succ = n.next.load( std::memory_order_acquire) ) ) {
+                            cpu_relax();
+                        }
+                        q_.next.store( succ, std::memory_order_relaxed);
+                    }
+                } else {
+                    q_.next.store( succ, std::memory_order_relaxed);
+                }
+                return;
+            }
+        }
+    }
+}
+
+void
+mcs_spinlock::unlock() noexcept {
+    BOOST_ASSERT( nullptr != q_.tail.load() );
+    node * succ = q_.next.load( std::memory_order_acquire);
+    if ( nullptr == succ) {
+        node * expected = & q_;
+        if ( q_.tail.compare_exchange_strong( expected, nullptr, std::memory_order_release) ) {
+            return;
+        }
+        // a waiter is linking itself to q_
+        while ( nullptr == ( succ = q_.next.load( std::memory_order_acquire) ) ) {
+            cpu_relax();
+        }
+    }
+    // hand over the lock
+    succ->tail.store( nullptr, std::memory_order_release);
+}
+
 }}}
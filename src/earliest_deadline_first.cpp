@@ -0,0 +1,188 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/earliest_deadline_first.hpp"
+
+#include <utility>
+
+#include <boost/assert.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+deadline_props *
+earliest_deadline_first::meld_( deadline_props * l, deadline_props * r) noexcept {
+    if ( nullptr == l) {
+        return r;
+    }
+    if ( nullptr == r) {
+        return l;
+    }
+    if ( less_( r, l) ) {
+        std::swap( l, r);
+    }
+    // r becomes the leftmost child of l
+    r->prev_ = l;
+    r->next_ = l->child_;
+    if ( nullptr != l->child_) {
+        l->child_->prev_ = r;
+    }
+    l->child_ = r;
+    return l;
+}
+
+deadline_props *
+earliest_deadline_first::merge_pairs_( deadline_props * first) noexcept {
+    // first pass: meld the siblings pairwise from left to right,
+    // the results are stacked (linked via next_)
+    deadline_props * stack = nullptr;
+    while ( nullptr != first) {
+        deadline_props * l = first;
+        deadline_props * r = l->next_;
+        first = nullptr != r ? r->next_ : nullptr;
+        l->prev_ = l->next_ = nullptr;
+        if ( nullptr != r) {
+            r->prev_ = r->next_ = nullptr;
+        }
+        deadline_props * p = meld_( l, r);
+        p->next_ = stack;
+        stack = p;
+    }
+    // second pass: meld from right to left
+    deadline_props * root = nullptr;
+    while ( nullptr != stack) {
+        deadline_props * p = stack;
+        stack = p->next_;
+        p->next_ = nullptr;
+        root = meld_( root, p);
+    }
+    return root;
+}
+
+void
+earliest_deadline_first::push_( deadline_props * p) noexcept {
+    BOOST_ASSERT( ! p->heap_linked_);
+    p->child_ = p->next_ = p->prev_ = nullptr;
+    p->seq_ = seq_++;
+    p->heap_linked_ = true;
+    // context::handoff() must not switch to a fiber stored in the heap
+    p->ctx_->queued_mark();
+    heap_ = meld_( heap_, p);
+}
+
+deadline_props *
+earliest_deadline_first::pop_() noexcept {
+    BOOST_ASSERT( nullptr != heap_);
+    deadline_props * p = heap_;
+    heap_ = merge_pairs_( p->child_);
+    p->child_ = nullptr;
+    p->heap_linked_ = false;
+    p->ctx_->queued_unmark();
+    return p;
+}
+
+void
+earliest_deadline_first::erase_( deadline_props * p) noexcept {
+    BOOST_ASSERT( p->heap_linked_);
+    if ( heap_ == p) {
+        pop_();
+        return;
+    }
+    // cut the subtree rooted at p
+    if ( p->prev_->child_ == p) {
+        p->prev_->child_ = p->next_;
+    } else {
+        p->prev_->next_ = p->next_;
+    }
+    if ( nullptr != p->next_) {
+        p->next_->prev_ = p->prev_;
+    }
+    p->prev_ = p->next_ = nullptr;
+    heap_ = meld_( heap_, merge_pairs_( p->child_) );
+    p->child_ = nullptr;
+    p->heap_linked_ = false;
+    p->ctx_->queued_unmark();
+}
+
+void
+earliest_deadline_first::awakened( context * ctx, deadline_props & props) noexcept {
+    BOOST_ASSERT( nullptr != ctx);
+    BOOST_ASSERT( ! ctx->ready_is_linked() );
+    if ( ctx->is_dispatcher_context() ) {
+        dispatcher_ = ctx;
+        return;
+    }
+    // a fiber readied by a timeout is still linked into a wait-queue,
+    // it might be signaled before it is resumed (scheduler::prepare_ready_()
+    // unlinks it from the ready-queue only)
+    if ( props.heap_linked_) {
+        erase_( & props);
+    }
+    if ( props.has_deadline() ) {
+        push_( & props);
+    } else {
+        ctx->ready_link( rqueue_);
+    }
+}
+
+context *
+earliest_deadline_first::pick_next() noexcept {
+    context * ctx = nullptr;
+    // resume the dispatcher-context first from time to time
+    // (sleeping and remotely signaled fibers)
+    if ( nullptr != dispatcher_ && 0 == ( ++ticks_ % 61) ) {
+        std::swap( ctx, dispatcher_);
+        return ctx;
+    }
+    if ( nullptr != heap_) {
+        return pop_()->ctx_;
+    }
+    if ( ! rqueue_.empty() ) {
+        ctx = & rqueue_.front();
+        rqueue_.pop_front();
+        return ctx;
+    }
+    std::swap( ctx, dispatcher_);
+    return ctx;
+}
+
+void
+earliest_deadline_first::property_change( context * ctx, deadline_props & props) noexcept {
+    BOOST_ASSERT( nullptr != ctx);
+    // the fiber might be running or blocked, its new
+    // deadline is applied when it becomes ready
+    if ( props.heap_linked_) {
+        erase_( & props);
+    } else if ( ctx->ready_is_linked() ) {
+        if ( ! props.has_deadline() ) {
+            // stays at its position in the FIFO queue
+            return;
+        }
+        rqueue_.erase( rqueue_t::s_iterator_to( * ctx) );
+    } else {
+        return;
+    }
+    awakened( ctx, props);
+}
+
+void
+earliest_deadline_first::suspend_until( std::chrono::steady_clock::time_point const& suspend_time) noexcept {
+    ev_.reset( suspend_time);
+}
+
+void
+earliest_deadline_first::notify() noexcept {
+    ev_.set();
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
@@ -0,0 +1,138 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/fiber_pool.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+#include <boost/assert.hpp>
+
+#include "boost/fiber/fixedsize_stack.hpp"
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+context *
+context_pool::create_() {
+    fixedsize_stack salloc( stack_size_);
+    boost::context::stack_context sctx = salloc.allocate();
+    // control structure, task and properties are placed
+    // on top of the stack
+    const std::size_t props_size = context::active_properties_size();
+    const std::size_t reserved = sizeof( context) + BOOST_FIBERS_POOL_TASK_SIZE + props_size;
+    void * sp = static_cast< char * >( sctx.sp) - reserved - alignof( context);
+    std::size_t space = reserved + alignof( context);
+    sp = std::align( alignof( context), reserved, sp, space);
+    BOOST_ASSERT( nullptr != sp);
+    const std::size_t size = sctx.size - ( static_cast< char * >( sctx.sp) - static_cast< char * >( sp) );
+    context * ctx = ::new ( sp) context(
+            pooled_context,
+            boost::context::preallocated( sp, size, sctx),
+            salloc,
+            this);
+    if ( 0 < props_size) {
+        ctx->set_properties_storage(
+                static_cast< char * >( sp) + sizeof( context) + BOOST_FIBERS_POOL_TASK_SIZE,
+                props_size);
+    }
+    // released by ~context()
+    intrusive_ptr_add_ref( this);
+    return ctx;
+}
+
+context_pool::context_pool( std::size_t max_idle, std::size_t stack_size) :
+    max_idle_{ max_idle },
+    stack_size_{ stack_size } {
+    // recycle() must not allocate
+    idle_.reserve( max_idle_);
+}
+
+context *
+context_pool::get() {
+    std::unique_lock< detail::spinlock > lk( splk_);
+    if ( ! idle_.empty() ) {
+        context * ctx = idle_.back();
+        idle_.pop_back();
+        return ctx;
+    }
+    lk.unlock();
+    return create_();
+}
+
+intrusive_ptr< context >
+context_pool::launch( context * ctx, pool_task * task) noexcept {
+    BOOST_ASSERT( nullptr != ctx);
+    BOOST_ASSERT( nullptr != task);
+    BOOST_ASSERT( 0 == ctx->use_count_);
+    BOOST_ASSERT( nullptr == ctx->task_);
+    BOOST_ASSERT( nullptr == ctx->get_properties() );
+    // reset the state of the terminated fiber
+    // reference of the scheduler, released after termination
+    ctx->use_count_ = 1;
+    ctx->flags_ = context::flag_worker_context;
+    ctx->tp_ = (std::chrono::steady_clock::time_point::max)();
+    ctx->task_ = task;
+    return intrusive_ptr< context >( ctx);
+}
+
+void
+context_pool::recycle( context * ctx) noexcept {
+    BOOST_ASSERT( nullptr != ctx);
+    // properties are constructed for each fiber
+    ctx->set_properties( nullptr);
+    std::unique_lock< detail::spinlock > lk( splk_);
+    if ( ! closed_ && idle_.size() < max_idle_) {
+        idle_.push_back( ctx);
+        return;
+    }
+    lk.unlock();
+    ctx->~context();
+}
+
+void
+context_pool::close() noexcept {
+    std::unique_lock< detail::spinlock > lk( splk_);
+    closed_ = true;
+    std::vector< context * > idle;
+    idle.swap( idle_);
+    lk.unlock();
+    for ( context * ctx : idle) {
+        ctx->~context();
+    }
+}
+
+std::size_t
+context_pool::idle() noexcept {
+    std::unique_lock< detail::spinlock > lk( splk_);
+    return idle_.size();
+}
+
+}
+
+fiber_pool::fiber_pool( std::size_t max_idle, std::size_t stack_size) :
+    impl_{ new detail::context_pool( max_idle, stack_size) } {
+}
+
+fiber_pool::~fiber_pool() {
+    impl_->close();
+}
+
+std::size_t
+fiber_pool::idle() const noexcept {
+    return impl_->idle();
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
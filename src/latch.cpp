@@ -0,0 +1,110 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/latch.hpp"
+
+#include <system_error>
+
+#include "boost/fiber/exceptions.hpp"
+#include "boost/fiber/scheduler.hpp"
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+constexpr std::ptrdiff_t latch::closing;
+
+latch::latch( std::ptrdiff_t expected) :
+    count_{ expected } {
+    if ( 0 > expected) {
+        throw fiber_error( std::make_error_code( std::errc::invalid_argument),
+                           "boost fiber: negative initial latch count");
+    }
+}
+
+void
+latch::count_down( std::ptrdiff_t n) {
+    std::ptrdiff_t count = count_.load( std::memory_order_relaxed);
+    for (;;) {
+        if ( 0 > n || count < n) {
+            throw fiber_error( std::make_error_code( std::errc::invalid_argument),
+                               "boost fiber: invalid latch update");
+        }
+        if ( 0 == n) {
+            return;
+        }
+        if ( count != n) {
+            if ( count_.compare_exchange_weak(
+                        count, count - n, std::memory_order_release, std::memory_order_relaxed) ) {
+                return;
+            }
+            continue;
+        }
+        detail::spinlock_lock lk( wait_queue_splk_);
+        if ( ! count_.compare_exchange_strong(
+                    count, closing, std::memory_order_acq_rel, std::memory_order_relaxed) ) {
+            continue;
+        }
+        wait_queue_t waiters;
+        waiters.swap( wait_queue_);
+        lk.unlock();
+        count_.store( 0, std::memory_order_release);
+        scheduler * sched = context::active()->get_scheduler();
+        // context' managed by the scheduler of this thread are
+        // passed to the scheduling algorithm at once
+        scheduler::ready_queue_t batch;
+        while ( ! waiters.empty() ) {
+            context * ctx = & waiters.front();
+            waiters.pop_front();
+            if ( sched == ctx->get_scheduler() ) {
+                sched->set_ready( ctx, batch);
+            } else {
+                ctx->get_scheduler()->set_remote_ready( ctx);
+            }
+        }
+        sched->set_ready( batch);
+        return;
+    }
+}
+
+void
+latch::wait() noexcept {
+    context * ctx = context::active();
+    for (;;) {
+        std::ptrdiff_t count = count_.load( std::memory_order_acquire);
+        if ( 0 == count) {
+            return;
+        }
+        if ( closing == count) {
+            // count_down() is about to store zero
+            ctx->yield();
+            continue;
+        }
+        detail::spinlock_lock lk( wait_queue_splk_);
+        if ( 0 < count_.load( std::memory_order_relaxed) ) {
+            BOOST_ASSERT( ! ctx->wait_is_linked() );
+            ctx->wait_link( wait_queue_);
+            // suspend this fiber
+            ctx->suspend( lk);
+            BOOST_ASSERT( ! ctx->wait_is_linked() );
+            return;
+        }
+    }
+}
+
+void
+latch::arrive_and_wait( std::ptrdiff_t n) {
+    count_down( n);
+    wait();
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
@@ -0,0 +1,50 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/priority_round_robin.hpp"
+
+#include <boost/assert.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+void
+priority_round_robin::property_change( context * ctx, priority_props & props) noexcept {
+    BOOST_ASSERT( nullptr != ctx);
+    // the fiber might be running or blocked, its new
+    // priority is applied when it becomes ready
+    if ( ! ctx->ready_is_linked() ) {
+        return;
+    }
+    std::size_t level = props.level_;
+    if ( level_of_( props.priority_) == level) {
+        return;
+    }
+    rqueues_[level].erase( rqueue_t::s_iterator_to( * ctx) );
+    if ( rqueues_[level].empty() ) {
+        mask_ &= ~bit_( level);
+    }
+    awakened( ctx, props);
+}
+
+void
+priority_round_robin::suspend_until( std::chrono::steady_clock::time_point const& suspend_time) noexcept {
+    ev_.reset( suspend_time);
+}
+
+void
+priority_round_robin::notify() noexcept {
+    ev_.set();
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
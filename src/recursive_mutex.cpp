@@ -6,11 +6,9 @@
 
 #include "boost/fiber/recursive_mutex.hpp"
 
-#include <algorithm>
-#include <functional>
+#include <system_error>
 
 #include "boost/fiber/exceptions.hpp"
-#include "boost/fiber/scheduler.hpp"
 
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
@@ -22,59 +20,39 @@ namespace fibers {
 void
 recursive_mutex::lock() {
     context * ctx = context::active();
-    // store this fiber in order to be notified later
-    detail::spinlock_lock lk( wait_queue_splk_);
-    if ( ctx == owner_) {
+    if ( impl_.try_lock( ctx) ) {
+        count_ = 1;
+    } else if ( ctx == impl_.owner() ) {
         ++count_;
-        return;
-    } else if ( nullptr == owner_) {
-        owner_ = ctx;
+    } else {
+        impl_.lock_slow( ctx);
         count_ = 1;
-        return;
     }
-    BOOST_ASSERT( ! ctx->wait_is_linked() );
-    ctx->wait_link( wait_queue_);
-    // suspend this fiber
-    ctx->suspend( lk);
-    BOOST_ASSERT( ! ctx->wait_is_linked() );
 }
 
 bool
-recursive_mutex::try_lock() noexcept { 
+recursive_mutex::try_lock() noexcept {
     context * ctx = context::active();
-    detail::spinlock_lock lk( wait_queue_splk_);
-    if ( nullptr == owner_) {
-        owner_ = ctx;
+    if ( impl_.try_lock( ctx) ) {
         count_ = 1;
-    } else if ( ctx == owner_) {
+    } else if ( ctx == impl_.owner() ) {
         ++count_;
+    } else {
+        return false;
     }
-    lk.unlock();
-    // let other fiber release the lock
-    context::active()->yield();
-    return ctx == owner_;
+    return true;
 }
 
 void
 recursive_mutex::unlock() {
     context * ctx = context::active();
-    detail::spinlock_lock lk( wait_queue_splk_);
-    if ( ctx != owner_) {
+    if ( ctx != impl_.owner() ) {
         throw lock_error(
                 std::make_error_code( std::errc::operation_not_permitted),
                 "boost fiber: no  privilege to perform the operation");
     }
     if ( 0 == --count_) {
-        if ( ! wait_queue_.empty() ) {
-            context * ctx = & wait_queue_.front();
-            wait_queue_.pop_front();
-            owner_ = ctx;
-            count_ = 1;
-            context::active()->set_ready( ctx);
-        } else {
-            owner_ = nullptr;
-            return;
-        }
+        impl_.unlock( ctx);
     }
 }
 
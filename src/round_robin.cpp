@@ -15,31 +15,6 @@
 namespace boost {
 namespace fibers {
 
-void
-round_robin::awakened( context * ctx) noexcept {
-    BOOST_ASSERT( nullptr != ctx);
-
-    BOOST_ASSERT( ! ctx->ready_is_linked() );
-    ctx->ready_link( ready_queue_);
-}
-
-context *
-round_robin::pick_next() noexcept {
-    context * victim{ nullptr };
-    if ( ! ready_queue_.empty() ) {
-        victim = & ready_queue_.front();
-        ready_queue_.pop_front();
-        BOOST_ASSERT( nullptr != victim);
-        BOOST_ASSERT( ! victim->ready_is_linked() );
-    }
-    return victim;
-}
-
-bool
-round_robin::has_ready_fibers() const noexcept {
-    return ! ready_queue_.empty();
-}
-
 void
 round_robin::suspend_until( std::chrono::steady_clock::time_point const& suspend_time) noexcept {
     ev_.reset( suspend_time);
@@ -0,0 +1,127 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/runtime.hpp"
+
+#include <algorithm>
+#include <system_error>
+
+#include "boost/fiber/context.hpp"
+#include "boost/fiber/detail/numa.hpp"
+#include "boost/fiber/exceptions.hpp"
+#include "boost/fiber/fiber_pool.hpp"
+#include "boost/fiber/scheduler.hpp"
+
+#if defined(__linux__)
+extern "C" {
+#include <pthread.h>
+#include <sched.h>
+}
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+runtime::runtime( std::size_t size, bool pin, std::function< void( std::size_t) > init) :
+    size_{ 0 != size ? size : ( std::max)( std::thread::hardware_concurrency(), 1u) },
+    queues_{ new queue_t[size_] } {
+    if ( pin) {
+        for ( std::size_t node = 0; node < detail::numa_node_count(); ++node) {
+            std::vector< std::size_t > cpus = detail::numa_node_cpus( node);
+            cpus_.insert( cpus_.end(), cpus.begin(), cpus.end() );
+        }
+        if ( cpus_.empty() ) {
+            cpus_.push_back( 0);
+        }
+    }
+    threads_.reserve( size_);
+    try {
+        for ( std::size_t i = 0; i < size_; ++i) {
+            threads_.emplace_back( & runtime::run_, this, i, pin, init);
+        }
+    } catch (...) {
+        close();
+        join();
+        throw;
+    }
+}
+
+runtime::~runtime() {
+    close();
+    join();
+}
+
+void
+runtime::run_( std::size_t idx, bool pin, std::function< void( std::size_t) > const& init) {
+#if defined(__linux__)
+    if ( pin) {
+        cpu_set_t set;
+        CPU_ZERO( & set);
+        CPU_SET( cpus_[idx % cpus_.size()], & set);
+        // pinning is a hint, errors are ignored
+        ::pthread_setaffinity_np( ::pthread_self(), sizeof( set), & set);
+    }
+#endif
+    if ( init) {
+        init( idx);
+    }
+    {
+        // terminated fibers are reused by later functions
+        fiber_pool pool;
+        detail::pool_task * task = nullptr;
+        while ( channel_op_status::success == queues_[idx].pop( task) ) {
+            pool.launch( [task](){
+                            task->run();
+                            task->destroy();
+                         }).detach();
+        }
+        // wait till all fibers have terminated, including
+        // fibers launched by the posted functions
+        context * active_ctx = context::active();
+        active_ctx->get_scheduler()->drain( active_ctx);
+    }
+}
+
+void
+runtime::post_( std::size_t idx, detail::pool_task * task) {
+    channel_op_status status = channel_op_status::closed;
+    try {
+        status = queues_[idx].push( task);
+    } catch (...) {
+        task->destroy();
+        throw;
+    }
+    if ( channel_op_status::success != status) {
+        task->destroy();
+        throw fiber_error( std::make_error_code( std::errc::operation_not_permitted),
+                           "boost fiber: runtime has been closed");
+    }
+}
+
+void
+runtime::close() noexcept {
+    for ( std::size_t i = 0; i < size_; ++i) {
+        queues_[i].close();
+    }
+}
+
+void
+runtime::join() {
+    for ( std::thread & t : threads_) {
+        if ( t.joinable() ) {
+            t.join();
+        }
+    }
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
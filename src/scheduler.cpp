@@ -8,12 +8,14 @@
 
 #include <chrono>
 #include <mutex>
+#include <typeinfo>
 
 #include <boost/assert.hpp>
 
 #include "boost/fiber/context.hpp"
 #include "boost/fiber/exceptions.hpp"
 #include "boost/fiber/round_robin.hpp"
+#include "boost/fiber/trace.hpp"
 
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
@@ -31,6 +33,10 @@ scheduler::resume_( context * active_ctx, context * ctx) noexcept {
     BOOST_ASSERT( this == ctx->get_scheduler() );
     BOOST_ASSERT( active_ctx->get_scheduler() == ctx->get_scheduler() );
     BOOST_ASSERT( active_ctx != ctx);
+    add_( counters_.context_switches, std::uint64_t( 1) );
+    running_.store( ctx, std::memory_order_relaxed);
+    BOOST_FIBERS_TRACE( suspend, active_ctx);
+    BOOST_FIBERS_TRACE( resume, ctx);
     // resume active-fiber == ctx
     ctx->resume();
     BOOST_ASSERT( context::active() == active_ctx);
@@ -45,6 +51,10 @@ scheduler::resume_( context * active_ctx, context * ctx, detail::spinlock_lock &
     BOOST_ASSERT( this == ctx->get_scheduler() );
     BOOST_ASSERT( active_ctx->get_scheduler() == ctx->get_scheduler() );
     BOOST_ASSERT( active_ctx != ctx);
+    add_( counters_.context_switches, std::uint64_t( 1) );
+    running_.store( ctx, std::memory_order_relaxed);
+    BOOST_FIBERS_TRACE( suspend, active_ctx);
+    BOOST_FIBERS_TRACE( resume, ctx);
     // resume active-fiber == ctx
     ctx->resume( lk);
     BOOST_ASSERT( context::active() == active_ctx);
@@ -60,14 +70,59 @@ scheduler::resume_( context * active_ctx, context * ctx, context * ready_ctx) no
     BOOST_ASSERT( this == ctx->get_scheduler() );
     BOOST_ASSERT( active_ctx->get_scheduler() == ctx->get_scheduler() );
     BOOST_ASSERT( active_ctx != ctx);
+    add_( counters_.context_switches, std::uint64_t( 1) );
+    running_.store( ctx, std::memory_order_relaxed);
+    BOOST_FIBERS_TRACE( suspend, active_ctx);
+    BOOST_FIBERS_TRACE( resume, ctx);
     // resume active-fiber == ctx
     ctx->resume( ready_ctx);
     BOOST_ASSERT( context::active() == active_ctx);
 }
 
+inline
+void
+scheduler::awakened_( context * ctx) noexcept {
+    if ( nullptr != rr_) {
+        rr_->round_robin::awakened( ctx);
+    } else {
+        sched_algo_->awakened( ctx);
+    }
+}
+
+inline
+context *
+scheduler::pick_next_() noexcept {
+    return nullptr != rr_
+        ? rr_->round_robin::pick_next()
+        : sched_algo_->pick_next();
+}
+
+inline
+bool
+scheduler::has_ready_fibers_() const noexcept {
+    return nullptr != rr_
+        ? rr_->round_robin::has_ready_fibers()
+        : sched_algo_->has_ready_fibers();
+}
+
+void
+scheduler::count_ready_() noexcept {
+    std::size_t ready = counters_.ready.load( std::memory_order_relaxed) + 1;
+    counters_.ready.store( ready, std::memory_order_relaxed);
+    if ( counters_.ready_high_water.load( std::memory_order_relaxed) < ready) {
+        counters_.ready_high_water.store( ready, std::memory_order_relaxed);
+    }
+}
+
 context *
 scheduler::get_next_() noexcept {
-    context * ctx = sched_algo_->pick_next();
+    context * ctx = pick_next_();
+    if ( nullptr == ctx) {
+        // resynchronize, fibers might have been stolen
+        counters_.ready.store( 0, std::memory_order_relaxed);
+    } else if ( ! ctx->is_dispatcher_context() && 0 < counters_.ready.load( std::memory_order_relaxed) ) {
+        add_( counters_.ready, std::size_t( -1) );
+    }
     //BOOST_ASSERT( nullptr == ctx);
     //BOOST_ASSERT( this == ctx->get_scheduler() );
     return ctx;
@@ -75,6 +130,10 @@ scheduler::get_next_() noexcept {
 
 void
 scheduler::release_terminated_() noexcept {
+    if ( terminated_queue_.empty() ) {
+        return;
+    }
+    std::chrono::steady_clock::time_point start = clock_.now();
     terminated_queue_t::iterator e( terminated_queue_.end() );
     for ( terminated_queue_t::iterator i( terminated_queue_.begin() );
             i != e;) {
@@ -96,28 +155,61 @@ scheduler::release_terminated_() noexcept {
         // the context is automatically removeid from worker-queue
         intrusive_ptr_release( ctx);
     }
+    add_( counters_.release_terminated_time, ( clock_.now() - start).count() );
 }
 
 void
-scheduler::remote_ready2ready_() noexcept {
-    // protect for concurrent access
-    std::unique_lock< detail::spinlock > lk( remote_ready_splk_);
-    // get context from remote ready-queue
-    while ( ! remote_ready_queue_.empty() ) {
-        context * ctx = & remote_ready_queue_.front();
-        remote_ready_queue_.pop_front();
-        // store context in local queues
+scheduler::drained_() noexcept {
+    std::unique_lock< detail::spinlock > lk( worker_splk_);
+    if ( worker_queue_.empty() ) {
+        context * ctx = drain_ctx_;
+        drain_ctx_ = nullptr;
+        lk.unlock();
         set_ready( ctx);
     }
 }
 
+void
+scheduler::remote_ready2ready_() noexcept {
+    // detach all context' from remote ready-queue
+    // with one atomic operation
+    ready_queue_t batch;
+    remote_ready_queue_.consume_all(
+        [this,&batch]( context * ctx) noexcept {
+            add_( counters_.remote_wakeups, std::uint64_t( 1) );
+            set_ready( ctx, batch);
+        });
+    // store context' in local queues
+    set_ready( batch);
+}
+
 void
 scheduler::sleep2ready_() noexcept {
+    // do not query the clock if no context is sleeping
+    if ( sleep_queue_.empty() ) {
+        return;
+    }
     // move context which the deadline has reached
     // to ready-queue
+    std::chrono::steady_clock::time_point now = clock_.now();
+#if defined(BOOST_FIBERS_USE_TIMER_WHEEL)
+    // timer-wheel unlinks expired context'
+    sleep_queue_.expire( now,
+        [this]( context * ctx) noexcept {
+            BOOST_ASSERT( ! ctx->is_dispatcher_context() );
+            BOOST_ASSERT( ! ctx->is_terminated() );
+            BOOST_ASSERT( ! ctx->ready_is_linked() );
+            BOOST_ASSERT( ! ctx->sleep_is_linked() );
+            // reset sleep-tp
+            ctx->tp_ = (std::chrono::steady_clock::time_point::max)();
+            add_( counters_.sleeping, std::size_t( -1) );
+            // push new context to ready-queue
+            count_ready_();
+            BOOST_FIBERS_TRACE( ready, ctx);
+            awakened_( ctx);
+        });
+#else
     // sleep-queue is sorted (ascending)
-    std::chrono::steady_clock::time_point now =
-        std::chrono::steady_clock::now();
     sleep_queue_t::iterator e = sleep_queue_.end();
     for ( sleep_queue_t::iterator i = sleep_queue_.begin(); i != e;) {
         context * ctx = & ( * i);
@@ -134,16 +226,35 @@ scheduler::sleep2ready_() noexcept {
             i = sleep_queue_.erase( i);
             // reset sleep-tp
             ctx->tp_ = (std::chrono::steady_clock::time_point::max)();
+            add_( counters_.sleeping, std::size_t( -1) );
             // push new context to ready-queue
-            sched_algo_->awakened( ctx);
+            count_ready_();
+            BOOST_FIBERS_TRACE( ready, ctx);
+            awakened_( ctx);
         } else {
             break; // first context with now < deadline
         }
     }
+#endif
+}
+
+std::chrono::steady_clock::time_point
+scheduler::next_deadline_() noexcept {
+#if defined(BOOST_FIBERS_USE_TIMER_WHEEL)
+    return sleep_queue_.next_deadline();
+#else
+    // get lowest deadline from sleep-queue
+    sleep_queue_t::iterator i = sleep_queue_.begin();
+    if ( sleep_queue_.end() != i) {
+        return i->tp_;
+    }
+    return (std::chrono::steady_clock::time_point::max)();
+#endif
 }
 
 scheduler::scheduler() noexcept :
     sched_algo_{ new round_robin() } {
+    rr_ = static_cast< round_robin * >( sched_algo_.get() );
 }
 
 scheduler::~scheduler() {
@@ -157,7 +268,7 @@ scheduler::~scheduler() {
     // no context' in worker-queue
     //BOOST_ASSERT( worker_queue_.empty() );
     BOOST_ASSERT( terminated_queue_.empty() );
-    BOOST_ASSERT( ! sched_algo_->has_ready_fibers() );
+    BOOST_ASSERT( ! has_ready_fibers_() );
     BOOST_ASSERT( remote_ready_queue_.empty() );
     BOOST_ASSERT( sleep_queue_.empty() );
     // set active context to nullptr
@@ -174,6 +285,10 @@ scheduler::dispatch() noexcept {
     while ( ! shutdown_) {
         // release termianted context'
         release_terminated_();
+        // resume main-context waiting in drain()
+        if ( BOOST_UNLIKELY( nullptr != drain_ctx_) ) {
+            drained_();
+        }
         // get context' from remote ready-queue
         remote_ready2ready_();
         // get sleeping context'
@@ -183,21 +298,17 @@ scheduler::dispatch() noexcept {
         if ( nullptr != ctx) {
             // push dispatcher-context to ready-queue
             // so that ready-queue never becomes empty
-            sched_algo_->awakened( dispatcher_ctx_.get() );
+            awakened_( dispatcher_ctx_.get() );
             resume_( dispatcher_ctx_.get(), ctx);
             BOOST_ASSERT( context::active() == dispatcher_ctx_.get() );
         } else {
             // no ready context, wait till signaled
-            // set deadline to highest value
-            std::chrono::steady_clock::time_point suspend_time =
-                    (std::chrono::steady_clock::time_point::max)();
-            // get lowest deadline from sleep-queue
-            sleep_queue_t::iterator i = sleep_queue_.begin();
-            if ( sleep_queue_.end() != i) {
-                suspend_time = i->tp_;
-            }
-            // no ready context, wait till signaled
-            sched_algo_->suspend_until( suspend_time);
+            // or till the lowest deadline of the sleep-queue
+            std::chrono::steady_clock::time_point start = clock_.now();
+            sched_algo_->suspend_until( next_deadline_() );
+            add_( counters_.idle_time, ( clock_.now() - start).count() );
+            // the next pass must see the expired deadline
+            clock_.idled();
         }
     }
     // loop till all context' have been terminated
@@ -220,7 +331,7 @@ scheduler::dispatch() noexcept {
         context * ctx = nullptr;
         if ( nullptr != ( ctx = get_next_() ) ) {
             // resume ready context's
-            sched_algo_->awakened( dispatcher_ctx_.get() );
+            awakened_( dispatcher_ctx_.get() );
             resume_( dispatcher_ctx_.get(), ctx);
             BOOST_ASSERT( context::active() == dispatcher_ctx_.get() );
         }
@@ -233,7 +344,7 @@ scheduler::dispatch() noexcept {
 }
 
 void
-scheduler::set_ready( context * ctx) noexcept {
+scheduler::prepare_ready_( context * ctx) noexcept {
     BOOST_ASSERT( nullptr != ctx);
     BOOST_ASSERT( ! ctx->is_terminated() );
     // dispatcher-context will never be passed to set_ready()
@@ -247,13 +358,39 @@ scheduler::set_ready( context * ctx) noexcept {
     if ( ctx->sleep_is_linked() ) {
         // unlink it from sleep-queue
         ctx->sleep_unlink();
+        add_( counters_.sleeping, std::size_t( -1) );
     }
     // for safety unlink it from ready-queue
     // this might happen if a newly created fiber was
     // signaled to interrupt
     ctx->ready_unlink();
+    count_ready_();
+    BOOST_FIBERS_TRACE( ready, ctx);
+}
+
+void
+scheduler::set_ready( context * ctx) noexcept {
+    prepare_ready_( ctx);
     // push new context to ready-queue
-    sched_algo_->awakened( ctx);
+    awakened_( ctx);
+}
+
+void
+scheduler::set_ready( context * ctx, ready_queue_t & batch) noexcept {
+    prepare_ready_( ctx);
+    ctx->ready_link( batch);
+}
+
+void
+scheduler::set_ready( ready_queue_t & batch) noexcept {
+    if ( ! batch.empty() ) {
+        // push new context' to ready-queue
+        if ( nullptr != rr_) {
+            rr_->round_robin::awakened_batch( batch);
+        } else {
+            sched_algo_->awakened_batch( batch);
+        }
+    }
 }
 
 void
@@ -267,13 +404,12 @@ scheduler::set_remote_ready( context * ctx) noexcept {
     // context ctx might in wait-/ready-/sleep-queue
     // we do not test this in this function
     // scheduler::dispatcher() has to take care
-    // protect for concurrent access
-    std::unique_lock< detail::spinlock > lk( remote_ready_splk_);
-    // push new context to remote ready-queue
-    ctx->remote_ready_link( remote_ready_queue_);
-    lk.unlock();
-    // notify scheduler
-    sched_algo_->notify();
+    // push new context to remote ready-queue (lock-free)
+    if ( ctx->remote_ready_link( remote_ready_queue_) ) {
+        BOOST_FIBERS_TRACE( remote_wakeup, ctx);
+        // notify scheduler
+        sched_algo_->notify();
+    }
 }
 
 void
@@ -291,6 +427,8 @@ scheduler::set_terminated( context * active_ctx) noexcept {
     // the dispatcher-context will call 
     // intrusive_ptr_release( ctx);
     active_ctx->terminated_link( terminated_queue_);
+    add_( counters_.fibers_terminated, std::uint64_t( 1) );
+    BOOST_FIBERS_TRACE( terminate, active_ctx);
     // resume another fiber
     resume_( active_ctx, get_next_() );
 }
@@ -310,10 +448,33 @@ scheduler::yield( context * active_ctx) noexcept {
     // from one ready-queue) the context must be
     // already suspended until another thread resumes it
     // (== maked as ready)
+    BOOST_FIBERS_TRACE( yield, active_ctx);
     // resume another fiber
     resume_( active_ctx, get_next_(), active_ctx);
 }
 
+void
+scheduler::handoff( context * active_ctx, context * ctx) noexcept {
+    BOOST_ASSERT( nullptr != active_ctx);
+    BOOST_ASSERT( nullptr != ctx);
+    BOOST_ASSERT( context::active() == active_ctx);
+    BOOST_ASSERT( ! active_ctx->is_terminated() );
+    BOOST_ASSERT( ! active_ctx->ready_is_linked() );
+    BOOST_ASSERT( ! ctx->is_dispatcher_context() );
+    BOOST_ASSERT( ! ctx->is_terminated() );
+    BOOST_ASSERT( ! ctx->ready_is_linked() );
+    // remove context ctx from sleep-queue
+    // (might happen if blocked in timed_mutex::try_lock_until())
+    if ( ctx->sleep_is_linked() ) {
+        ctx->sleep_unlink();
+        add_( counters_.sleeping, std::size_t( -1) );
+    }
+    // resume ctx without going through the ready-queue;
+    // like in yield() the active context is passed to set_ready()
+    // by ctx after the switch
+    resume_( active_ctx, ctx, active_ctx);
+}
+
 bool
 scheduler::wait_until( context * active_ctx,
                        std::chrono::steady_clock::time_point const& sleep_tp) noexcept {
@@ -336,11 +497,19 @@ scheduler::wait_until( context * active_ctx,
     // push active context to sleep-queue
     active_ctx->tp_ = sleep_tp;
     active_ctx->sleep_link( sleep_queue_);
+    add_( counters_.sleeping, std::size_t( 1) );
+    BOOST_FIBERS_TRACE( sleep, active_ctx);
     // resume another context
     resume_( active_ctx, get_next_() );
     // context has been resumed
     // check if deadline has reached
-    return std::chrono::steady_clock::now() < sleep_tp;
+    // sleep2ready_() resets tp_ if the deadline expired; the
+    // context might have been resumed by another thread
+    // (work-stealing), the clock of this scheduler must not be read
+    bool signaled = (std::chrono::steady_clock::time_point::max)() != active_ctx->tp_ ||
+                    (std::chrono::steady_clock::time_point::max)() == sleep_tp;
+    active_ctx->tp_ = (std::chrono::steady_clock::time_point::max)();
+    return signaled;
 }
 
 bool
@@ -366,11 +535,19 @@ scheduler::wait_until( context * active_ctx,
     // push active context to sleep-queue
     active_ctx->tp_ = sleep_tp;
     active_ctx->sleep_link( sleep_queue_);
+    add_( counters_.sleeping, std::size_t( 1) );
+    BOOST_FIBERS_TRACE( sleep, active_ctx);
     // resume another context
     resume_( active_ctx, get_next_(), lk);
     // context has been resumed
     // check if deadline has reached
-    return std::chrono::steady_clock::now() < sleep_tp;
+    // sleep2ready_() resets tp_ if the deadline expired; the
+    // context might have been resumed by another thread
+    // (work-stealing), the clock of this scheduler must not be read
+    bool signaled = (std::chrono::steady_clock::time_point::max)() != active_ctx->tp_ ||
+                    (std::chrono::steady_clock::time_point::max)() == sleep_tp;
+    active_ctx->tp_ = (std::chrono::steady_clock::time_point::max)();
+    return signaled;
 }
 
 void
@@ -392,15 +569,60 @@ scheduler::suspend( context * active_ctx,
 
 bool
 scheduler::has_ready_fibers() const noexcept {
-    return sched_algo_->has_ready_fibers();
+    return has_ready_fibers_();
+}
+
+scheduler_stats
+scheduler::stats() const noexcept {
+    scheduler_stats s;
+    s.context_switches = counters_.context_switches.load( std::memory_order_relaxed);
+    s.ready_queue_high_water = counters_.ready_high_water.load( std::memory_order_relaxed);
+    s.remote_wakeups = counters_.remote_wakeups.load( std::memory_order_relaxed);
+    s.sleep_queue_size = counters_.sleeping.load( std::memory_order_relaxed);
+    s.idle_time = std::chrono::steady_clock::duration{ counters_.idle_time.load( std::memory_order_relaxed) };
+    s.fibers_created = counters_.fibers_created.load( std::memory_order_relaxed);
+    s.fibers_terminated = counters_.fibers_terminated.load( std::memory_order_relaxed);
+    s.release_terminated_time = std::chrono::steady_clock::duration{ counters_.release_terminated_time.load( std::memory_order_relaxed) };
+    return s;
+}
+
+void
+scheduler::drain( context * active_ctx) noexcept {
+    BOOST_ASSERT( nullptr != active_ctx);
+    BOOST_ASSERT( main_ctx_ == active_ctx);
+    std::unique_lock< detail::spinlock > lk( worker_splk_);
+    if ( worker_queue_.empty() ) {
+        return;
+    }
+    drain_ctx_ = active_ctx;
+    lk.unlock();
+    // resumed by the dispatcher-context
+    suspend( active_ctx);
+}
+
+void
+scheduler::set_handoff( bool handoff) noexcept {
+    handoff_ = handoff;
+}
+
+bool
+scheduler::handoff_enabled() const noexcept {
+    return handoff_;
 }
 
 void
 scheduler::set_sched_algo( std::unique_ptr< sched_algorithm > algo) noexcept {
     // move remaining cotnext in current scheduler to new one
-    while ( sched_algo_->has_ready_fibers() ) {
-        algo->awakened( sched_algo_->pick_next() );
+    while ( has_ready_fibers_() ) {
+        algo->awakened( pick_next_() );
     }
+    // classes derived from round_robin might override its functions
+    rr_ = typeid( * algo) == typeid( round_robin)
+        ? static_cast< round_robin * >( algo.get() )
+        : nullptr;
+    sched_algorithm_with_properties_base * with_props =
+        dynamic_cast< sched_algorithm_with_properties_base * >( algo.get() );
+    properties_size_ = nullptr != with_props ? with_props->properties_size() : 0;
     sched_algo_ = std::move( algo);
 }
 
@@ -412,6 +634,7 @@ scheduler::attach_main_context( context * main_ctx) noexcept {
     // should not be in worker-queue
     main_ctx_ = main_ctx;
     main_ctx_->scheduler_ = this;
+    running_.store( main_ctx, std::memory_order_relaxed);
 }
 
 void
@@ -430,7 +653,7 @@ scheduler::attach_dispatcher_context( intrusive_ptr< context > dispatcher_ctx) n
     // the dispatcher-context is resumed and
     // scheduler::dispatch() is executed
     dispatcher_ctx_->scheduler_ = this;
-    sched_algo_->awakened( dispatcher_ctx_.get() );
+    awakened_( dispatcher_ctx_.get() );
 }
 
 void
@@ -445,6 +668,8 @@ scheduler::attach_worker_context( context * ctx) noexcept {
     BOOST_ASSERT( ! ctx->worker_is_linked() );
     ctx->worker_link( worker_queue_);
     ctx->scheduler_ = this;
+    add_( counters_.fibers_created, std::uint64_t( 1) );
+    BOOST_FIBERS_TRACE( create, ctx);
 }
 
 void
@@ -458,6 +683,12 @@ scheduler::detach_worker_context( context * ctx) noexcept {
     BOOST_ASSERT( ! ctx->wait_is_linked() );
     std::unique_lock< detail::spinlock > lk( worker_splk_);
     ctx->worker_unlink();
+    if ( nullptr != drain_ctx_ && worker_queue_.empty() ) {
+        lk.unlock();
+        // might be called by another thread (migration),
+        // wake up the dispatcher-context waiting in suspend_until()
+        sched_algo_->notify();
+    }
 }
 
 }}
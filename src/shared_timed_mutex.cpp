@@ -0,0 +1,105 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/shared_timed_mutex.hpp"
+
+#include <system_error>
+
+#include "boost/fiber/exceptions.hpp"
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+bool
+shared_timed_mutex::try_lock_until_( std::chrono::steady_clock::time_point const& timeout_time) noexcept {
+    if ( std::chrono::steady_clock::now() > timeout_time) {
+        return false;
+    }
+    context * ctx = context::active();
+    // a fiber owning the mutex times out
+    return ctx != impl_.owner() && impl_.try_lock_until( ctx, timeout_time);
+}
+
+bool
+shared_timed_mutex::try_lock_shared_until_( std::chrono::steady_clock::time_point const& timeout_time) noexcept {
+    if ( std::chrono::steady_clock::now() > timeout_time) {
+        return false;
+    }
+    context * ctx = context::active();
+    // a fiber owning the mutex times out
+    return ctx != impl_.owner() && impl_.try_lock_shared_until( ctx, timeout_time);
+}
+
+void
+shared_timed_mutex::lock() {
+    context * ctx = context::active();
+    if ( ctx == impl_.owner() ) {
+        throw lock_error(
+                std::make_error_code( std::errc::resource_deadlock_would_occur),
+                "boost fiber: a deadlock is detected");
+    }
+    impl_.lock( ctx);
+}
+
+bool
+shared_timed_mutex::try_lock() {
+    context * ctx = context::active();
+    if ( ctx == impl_.owner() ) {
+        throw lock_error(
+                std::make_error_code( std::errc::resource_deadlock_would_occur),
+                "boost fiber: a deadlock is detected");
+    }
+    return impl_.try_lock( ctx);
+}
+
+void
+shared_timed_mutex::unlock() {
+    if ( context::active() != impl_.owner() ) {
+        throw lock_error(
+                std::make_error_code( std::errc::operation_not_permitted),
+                "boost fiber: no  privilege to perform the operation");
+    }
+    impl_.unlock();
+}
+
+void
+shared_timed_mutex::lock_shared() {
+    context * ctx = context::active();
+    if ( ctx == impl_.owner() ) {
+        throw lock_error(
+                std::make_error_code( std::errc::resource_deadlock_would_occur),
+                "boost fiber: a deadlock is detected");
+    }
+    impl_.lock_shared( ctx);
+}
+
+bool
+shared_timed_mutex::try_lock_shared() {
+    if ( context::active() == impl_.owner() ) {
+        throw lock_error(
+                std::make_error_code( std::errc::resource_deadlock_would_occur),
+                "boost fiber: a deadlock is detected");
+    }
+    return impl_.try_lock_shared();
+}
+
+void
+shared_timed_mutex::unlock_shared() {
+    if ( ! impl_.unlock_shared() ) {
+        throw lock_error(
+                std::make_error_code( std::errc::operation_not_permitted),
+                "boost fiber: no  privilege to perform the operation");
+    }
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
@@ -6,11 +6,9 @@
 
 #include "boost/fiber/timed_mutex.hpp"
 
-#include <algorithm>
-#include <functional>
+#include <system_error>
 
 #include "boost/fiber/exceptions.hpp"
-#include "boost/fiber/scheduler.hpp"
 
 #ifdef BOOST_HAS_ABI_HEADERS
 #  include BOOST_ABI_PREFIX
@@ -25,80 +23,50 @@ timed_mutex::try_lock_until_( std::chrono::steady_clock::time_point const& timeo
         return false;
     }
     context * ctx = context::active();
-    // store this fiber in order to be notified later
-    detail::spinlock_lock lk( wait_queue_splk_);
-    if ( nullptr == owner_) {
-        owner_ = ctx;
+    if ( impl_.try_lock( ctx) ) {
         return true;
     }
-    BOOST_ASSERT( ! ctx->wait_is_linked() );
-    ctx->wait_link( wait_queue_);
-    // suspend this fiber until notified or timed-out
-    if ( ! context::active()->wait_until( timeout_time, lk) ) {
-        // remove fiber from wait-queue 
-        lk.lock();
-        ctx->wait_unlink();
-        return false;
-    }
-    BOOST_ASSERT( ! ctx->wait_is_linked() );
-    return true;
+    // a fiber owning the mutex times out
+    return ctx != impl_.owner() && impl_.try_lock_until( ctx, timeout_time);
 }
 
 void
 timed_mutex::lock() {
     context * ctx = context::active();
-    // store this fiber in order to be notified later
-    detail::spinlock_lock lk( wait_queue_splk_);
-    if ( ctx == owner_) {
+    if ( impl_.try_lock( ctx) ) {
+        return;
+    }
+    if ( ctx == impl_.owner() ) {
         throw lock_error(
                 std::make_error_code( std::errc::resource_deadlock_would_occur),
                 "boost fiber: a deadlock is detected");
-    } else if ( nullptr == owner_) {
-        owner_ = ctx;
-        return;
     }
-    BOOST_ASSERT( ! ctx->wait_is_linked() );
-    ctx->wait_link( wait_queue_);
-    // suspend this fiber
-    ctx->suspend( lk);
-    BOOST_ASSERT( ! ctx->wait_is_linked() );
+    impl_.lock_slow( ctx);
 }
 
 bool
 timed_mutex::try_lock() {
     context * ctx = context::active();
-    detail::spinlock_lock lk( wait_queue_splk_);
-    if ( ctx == owner_) {
+    if ( impl_.try_lock( ctx) ) {
+        return true;
+    }
+    if ( ctx == impl_.owner() ) {
         throw lock_error(
                 std::make_error_code( std::errc::resource_deadlock_would_occur),
                 "boost fiber: a deadlock is detected");
-    } else if ( nullptr == owner_) {
-        owner_ = ctx;
     }
-    lk.unlock();
-    // let other fiber release the lock
-    context::active()->yield();
-    return ctx == owner_;
+    return false;
 }
 
 void
 timed_mutex::unlock() {
     context * ctx = context::active();
-    detail::spinlock_lock lk( wait_queue_splk_);
-    if ( ctx != owner_) {
+    if ( ctx != impl_.owner() ) {
         throw lock_error(
                 std::make_error_code( std::errc::operation_not_permitted),
                 "boost fiber: no  privilege to perform the operation");
     }
-    if ( ! wait_queue_.empty() ) {
-        context * ctx = & wait_queue_.front();
-        wait_queue_.pop_front();
-        owner_ = ctx;
-        context::active()->set_ready( ctx);
-    } else {
-        owner_ = nullptr;
-        return;
-    }
+    impl_.unlock( ctx);
 }
 
 }}
@@ -0,0 +1,192 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/trace.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+#include <boost/assert.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+namespace detail {
+
+std::atomic< bool > trace_enabled_{ false };
+
+namespace {
+
+static_assert( 0 == ( BOOST_FIBERS_TRACE_BUFFER_SIZE & ( BOOST_FIBERS_TRACE_BUFFER_SIZE - 1) ),
+               "BOOST_FIBERS_TRACE_BUFFER_SIZE must be a power of 2");
+
+// single-producer/single-consumer ring buffer
+// producer: thread owning the buffer, consumer: trace_collect()
+class trace_buffer {
+private:
+    enum {
+        capacity = BOOST_FIBERS_TRACE_BUFFER_SIZE
+    };
+
+    std::unique_ptr< trace_record[] >                       records_{ new trace_record[capacity] };
+    std::uint32_t                                           thread_;
+    alignas(BOOST_FIBERS_CACHELINE_LENGTH) std::atomic< std::size_t >  head_{ 0 };
+    alignas(BOOST_FIBERS_CACHELINE_LENGTH) std::atomic< std::size_t >  tail_{ 0 };
+
+public:
+    explicit trace_buffer( std::uint32_t thread) noexcept :
+        thread_{ thread } {
+    }
+
+    void push( trace_event ev, context * ctx) noexcept {
+        std::size_t head = head_.load( std::memory_order_relaxed);
+        if ( capacity == head - tail_.load( std::memory_order_acquire) ) {
+            // full, drop the event
+            return;
+        }
+        trace_record & r = records_[head & ( capacity - 1)];
+        r.tp = std::chrono::steady_clock::now();
+        r.id = nullptr != ctx ? ctx->get_id() : context::id{};
+        r.thread = thread_;
+        r.event = ev;
+        head_.store( head + 1, std::memory_order_release);
+    }
+
+    void consume( std::vector< trace_record > & records) {
+        std::size_t tail = tail_.load( std::memory_order_relaxed);
+        std::size_t head = head_.load( std::memory_order_acquire);
+        for ( ; tail != head; ++tail) {
+            records.push_back( records_[tail & ( capacity - 1)]);
+        }
+        tail_.store( tail, std::memory_order_release);
+    }
+};
+
+class trace_registry {
+private:
+    std::mutex                                          mtx_{};
+    std::vector< std::shared_ptr< trace_buffer > >      buffers_{};
+    std::uint32_t                                       count_{ 0 };
+
+public:
+    std::shared_ptr< trace_buffer > attach() {
+        std::unique_lock< std::mutex > lk( mtx_);
+        std::shared_ptr< trace_buffer > buffer = std::make_shared< trace_buffer >( count_++);
+        buffers_.push_back( buffer);
+        return buffer;
+    }
+
+    std::vector< trace_record > collect() {
+        std::vector< trace_record > records;
+        std::unique_lock< std::mutex > lk( mtx_);
+        for ( std::shared_ptr< trace_buffer > const& buffer : buffers_) {
+            buffer->consume( records);
+        }
+        // release buffers of terminated threads
+        buffers_.erase(
+            std::remove_if( buffers_.begin(), buffers_.end(),
+                            []( std::shared_ptr< trace_buffer > const& buffer) {
+                                return 1 == buffer.use_count();
+                            }),
+            buffers_.end() );
+        lk.unlock();
+        std::stable_sort( records.begin(), records.end(),
+                          []( trace_record const& l, trace_record const& r) {
+                              return l.tp < r.tp;
+                          });
+        return records;
+    }
+};
+
+trace_registry & registry() {
+    static trace_registry r;
+    return r;
+}
+
+char const* name_of( trace_event ev) noexcept {
+    switch ( ev) {
+    case trace_event::create: return "create";
+    case trace_event::resume: return "resume";
+    case trace_event::suspend: return "suspend";
+    case trace_event::yield: return "yield";
+    case trace_event::sleep: return "sleep";
+    case trace_event::ready: return "ready";
+    case trace_event::remote_wakeup: return "remote_wakeup";
+    case trace_event::terminate: return "terminate";
+    }
+    return "unknown";
+}
+
+}
+
+void trace_push_( trace_event ev, context * ctx) noexcept {
+    static thread_local std::shared_ptr< trace_buffer > buffer;
+    if ( ! buffer) {
+        try {
+            buffer = registry().attach();
+        } catch (...) {
+            return;
+        }
+    }
+    buffer->push( ev, ctx);
+}
+
+}
+
+void trace_enable( bool enable) noexcept {
+    detail::trace_enabled_.store( enable, std::memory_order_relaxed);
+}
+
+bool trace_enabled() noexcept {
+    return detail::trace_enabled_.load( std::memory_order_relaxed);
+}
+
+std::vector< trace_record > trace_collect() {
+    return detail::registry().collect();
+}
+
+void trace_export_chrome( std::ostream & os, std::vector< trace_record > const& records) {
+    // fibers are numbered in order of appearance
+    std::map< context::id, std::size_t > fibers;
+    std::chrono::steady_clock::time_point origin =
+        records.empty() ? std::chrono::steady_clock::time_point{} : records.front().tp;
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for ( trace_record const& r : records) {
+        std::size_t fiber = fibers.emplace( r.id, fibers.size() + 1).first->second;
+        std::chrono::duration< double, std::micro > ts = r.tp - origin;
+        if ( ! first) {
+            os << ",";
+        }
+        first = false;
+        os << "\n{\"pid\":" << r.thread << ",\"tid\":" << fiber << ",\"ts\":" << ts.count();
+        switch ( r.event) {
+        case trace_event::resume:
+            // slice of a running fiber
+            os << ",\"ph\":\"B\",\"name\":\"running\"}";
+            break;
+        case trace_event::suspend:
+            os << ",\"ph\":\"E\",\"name\":\"running\"}";
+            break;
+        default:
+            os << ",\"ph\":\"i\",\"s\":\"t\",\"name\":\"" << detail::name_of( r.event) << "\"}";
+            break;
+        }
+    }
+    os << "\n]}\n";
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
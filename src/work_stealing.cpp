@@ -0,0 +1,225 @@
+
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "boost/fiber/work_stealing.hpp"
+
+#include <random>
+
+#include <boost/assert.hpp>
+
+#include "boost/fiber/detail/numa.hpp"
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace fibers {
+
+work_stealing_group::work_stealing_group( std::size_t size) :
+    size_{ size },
+    nodes_{ detail::numa_node_count() },
+    members_{ new member[size] } {
+    BOOST_ASSERT( 0 < size_);
+}
+
+std::size_t
+work_stealing_group::attach_() noexcept {
+    std::size_t idx = count_.fetch_add( 1);
+    BOOST_ASSERT_MSG( idx < size_, "too many schedulers attached to work_stealing_group");
+    return idx;
+}
+
+bool
+work_stealing_group::has_work_() const noexcept {
+    std::size_t count = count_.load();
+    for ( std::size_t i = 0; i < count; ++i) {
+        if ( ! members_[i].rqueue.empty() ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+work_stealing_group::notify_idle_( std::size_t idx) noexcept {
+    std::size_t count = count_.load();
+    std::size_t node = members_[idx].node.load( std::memory_order_relaxed);
+    // wake up one idle scheduler, it will steal the work
+    // schedulers on the NUMA node of idx are preferred
+    std::size_t other = count;
+    for ( std::size_t i = 0; i < count; ++i) {
+        if ( i != idx && members_[i].idle.load() ) {
+            if ( node == members_[i].node.load( std::memory_order_relaxed) ) {
+                members_[i].ev.set();
+                return;
+            }
+            if ( count == other) {
+                other = i;
+            }
+        }
+    }
+    if ( count != other) {
+        members_[other].ev.set();
+    }
+}
+
+work_stealing::work_stealing( std::shared_ptr< work_stealing_group > group, bool suspend) :
+    group_{ group },
+    idx_{ group_->attach_() },
+    self_( group_->members_[idx_]),
+    generator_{ static_cast< std::minstd_rand::result_type >( std::random_device{}() ) },
+    suspend_{ suspend } {
+    self_.node.store( detail::numa_current_node(), std::memory_order_relaxed);
+}
+
+context *
+work_stealing::steal_( bool local) noexcept {
+    std::size_t count = group_->count_.load();
+    std::size_t node = self_.node.load( std::memory_order_relaxed);
+    std::uniform_int_distribution< std::size_t > distribution{ 0, count - 1 };
+    for ( std::size_t i = 0; i < count; ++i) {
+        // choose a random victim
+        std::size_t victim = distribution( generator_);
+        if ( idx_ == victim ||
+             local != ( node == group_->members_[victim].node.load( std::memory_order_relaxed) ) ) {
+            continue;
+        }
+        context * ctx = group_->members_[victim].rqueue.steal();
+        if ( nullptr != ctx) {
+            BOOST_ASSERT( ! ctx->is_main_context() );
+            BOOST_ASSERT( ! ctx->is_dispatcher_context() );
+            BOOST_ASSERT( ! ctx->ready_is_linked() );
+            BOOST_ASSERT( ! ctx->sleep_is_linked() );
+            BOOST_ASSERT( ! ctx->terminated_is_linked() );
+            // attach context to the scheduler of this thread
+            context::active()->migrate( ctx);
+            // unmark after migration, the victim might signal
+            // the context while it is still attached to it
+            ctx->queued_unmark();
+            return ctx;
+        }
+    }
+    return nullptr;
+}
+
+context *
+work_stealing::steal_() noexcept {
+    if ( 2 > group_->count_.load() ) {
+        return nullptr;
+    }
+    // victims on the same NUMA node first, a migrated fiber accesses
+    // its stack across nodes
+    context * ctx = steal_( true);
+    if ( nullptr == ctx && 1 < group_->nodes_ ) {
+        ctx = steal_( false);
+    }
+    return ctx;
+}
+
+bool
+work_stealing::push_( context * ctx) noexcept {
+    BOOST_ASSERT( nullptr != ctx);
+    BOOST_ASSERT( ! ctx->ready_is_linked() );
+    if ( ctx->is_main_context() || ctx->is_dispatcher_context() ) {
+        ctx->ready_link( pinned_queue_);
+        return false;
+    }
+    if ( ! ctx->queued_mark() ) {
+        // context is already stored in a ready-queue
+        return false;
+    }
+    self_.rqueue.push( ctx);
+    return true;
+}
+
+void
+work_stealing::notify_idle_() noexcept {
+    // pairs with the fence in suspend_until()
+    std::atomic_thread_fence( std::memory_order_seq_cst);
+    if ( 0 < group_->idle_.load( std::memory_order_relaxed) ) {
+        group_->notify_idle_( idx_);
+    }
+}
+
+void
+work_stealing::awakened( context * ctx) noexcept {
+    if ( push_( ctx) ) {
+        notify_idle_();
+    }
+}
+
+void
+work_stealing::awakened_batch( ready_queue_type & batch) noexcept {
+    bool pushed = false;
+    while ( ! batch.empty() ) {
+        context * ctx = & batch.front();
+        batch.pop_front();
+        pushed = push_( ctx) || pushed;
+    }
+    // signal idle schedulers once per batch
+    if ( pushed) {
+        notify_idle_();
+    }
+}
+
+context *
+work_stealing::pick_next() noexcept {
+    context * ctx = nullptr;
+    // worker fibers are resumed first; from time to time
+    // resume main- or dispatcher-context first so that they do not
+    // starve if worker fibers keep yielding to each other
+    if ( ! pinned_queue_.empty() && 0 == ( ++ticks_ % 61) ) {
+        ctx = & pinned_queue_.front();
+        pinned_queue_.pop_front();
+        return ctx;
+    }
+    ctx = self_.rqueue.pop();
+    if ( nullptr != ctx) {
+        ctx->queued_unmark();
+        return ctx;
+    }
+    // no local work, try to steal from other schedulers
+    ctx = steal_();
+    if ( nullptr == ctx && ! pinned_queue_.empty() ) {
+        ctx = & pinned_queue_.front();
+        pinned_queue_.pop_front();
+    }
+    return ctx;
+}
+
+bool
+work_stealing::has_ready_fibers() const noexcept {
+    return ! self_.rqueue.empty() || ! pinned_queue_.empty();
+}
+
+void
+work_stealing::suspend_until( std::chrono::steady_clock::time_point const& suspend_time) noexcept {
+    if ( ! suspend_) {
+        // keep polling the other schedulers for work
+        return;
+    }
+    self_.idle.store( true);
+    ++group_->idle_;
+    // pairs with the fence in awakened()
+    std::atomic_thread_fence( std::memory_order_seq_cst);
+    if ( ! group_->has_work_() ) {
+        self_.ev.reset( suspend_time);
+    }
+    --group_->idle_;
+    self_.idle.store( false);
+}
+
+void
+work_stealing::notify() noexcept {
+    self_.ev.set();
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
@@ -0,0 +1,100 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <chrono>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+#include <boost/fiber/detail/clock.hpp>
+
+template< typename Clock >
+void do_test_clock( std::chrono::steady_clock::duration tolerance) {
+    Clock clk;
+    std::chrono::steady_clock::time_point last = clk.now();
+    for ( int i = 0; i < 20; ++i) {
+        std::chrono::steady_clock::time_point before = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point tp = clk.now();
+        std::chrono::steady_clock::time_point after = std::chrono::steady_clock::now();
+        // monotonic and close to std::chrono::steady_clock
+        BOOST_CHECK( last <= tp);
+        BOOST_CHECK( before - tolerance <= tp);
+        BOOST_CHECK( tp <= after + tolerance);
+        last = tp;
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1) );
+    }
+}
+
+void test_steady_clock() {
+    do_test_clock< boost::fibers::detail::steady_clock >( std::chrono::steady_clock::duration::zero() );
+}
+
+void test_coarse_clock() {
+#if defined(__linux__)
+    // one kernel tick
+    do_test_clock< boost::fibers::detail::coarse_clock >( std::chrono::milliseconds( 20) );
+#endif
+}
+
+void test_tsc_clock() {
+#if defined(__x86_64__) || defined(__i386__)
+    do_test_clock< boost::fibers::detail::tsc_clock >( std::chrono::milliseconds( 1) );
+#endif
+}
+
+void test_wait_for_timeout() {
+    // the deadline is checked against the time cached by the scheduler
+    boost::fibers::mutex mtx;
+    boost::fibers::condition_variable cond;
+    boost::fibers::cv_status status = boost::fibers::cv_status::no_timeout;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    boost::fibers::fiber f( [&](){
+                                std::unique_lock< boost::fibers::mutex > lk( mtx);
+                                start = std::chrono::steady_clock::now();
+                                status = cond.wait_for( lk, std::chrono::milliseconds( 10) );
+                                end = std::chrono::steady_clock::now();
+                            });
+    f.join();
+    BOOST_CHECK( boost::fibers::cv_status::timeout == status);
+    // tsc_clock may be ahead of std::chrono::steady_clock by some microseconds
+    BOOST_CHECK( std::chrono::milliseconds( 9) <= end - start);
+}
+
+void test_wait_for_no_timeout() {
+    boost::fibers::mutex mtx;
+    boost::fibers::condition_variable cond;
+    boost::fibers::cv_status status = boost::fibers::cv_status::timeout;
+    bool flag = false;
+    boost::fibers::fiber f1( [&](){
+                                std::unique_lock< boost::fibers::mutex > lk( mtx);
+                                while ( ! flag) {
+                                    status = cond.wait_for( lk, std::chrono::seconds( 10) );
+                                }
+                            });
+    boost::fibers::fiber f2( [&](){
+                                boost::this_fiber::sleep_for( std::chrono::milliseconds( 10) );
+                                std::unique_lock< boost::fibers::mutex > lk( mtx);
+                                flag = true;
+                                cond.notify_one();
+                            });
+    f1.join();
+    f2.join();
+    BOOST_CHECK( boost::fibers::cv_status::no_timeout == status);
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: clock test suite");
+
+    test->add( BOOST_TEST_CASE( & test_steady_clock) );
+    test->add( BOOST_TEST_CASE( & test_coarse_clock) );
+    test->add( BOOST_TEST_CASE( & test_tsc_clock) );
+    test->add( BOOST_TEST_CASE( & test_wait_for_timeout) );
+    test->add( BOOST_TEST_CASE( & test_wait_for_no_timeout) );
+
+    return test;
+}
@@ -11,6 +11,7 @@
 #include <cstdio>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <stdexcept>
 #include <vector>
 
@@ -484,6 +485,60 @@ void test_condition_wait_for_pred() {
     do_test_condition_wait_for_pred();
 }
 
+void test_notify_one_handoff() {
+    std::vector< int > order;
+    boost::fibers::mutex mtx;
+    boost::fibers::condition_variable cond;
+    bool flag = false;
+    boost::fibers::use_handoff( true);
+    boost::fibers::fiber f( [&mtx,&cond,&flag,&order](){
+                                std::unique_lock< boost::fibers::mutex > lk( mtx);
+                                cond.wait( lk, [&flag](){ return flag; });
+                                order.push_back( 2);
+                            });
+    // let f block on cond
+    boost::this_fiber::yield();
+    {
+        std::unique_lock< boost::fibers::mutex > lk( mtx);
+        flag = true;
+    }
+    // f is resumed by notify_one()
+    cond.notify_one();
+    order.push_back( 1);
+    f.join();
+    boost::fibers::use_handoff( false);
+    BOOST_REQUIRE_EQUAL( 2u, order.size() );
+    BOOST_CHECK_EQUAL( 2, order[0]);
+    BOOST_CHECK_EQUAL( 1, order[1]);
+}
+
+void test_wait_handoff() {
+    std::vector< int > order;
+    boost::fibers::mutex mtx;
+    boost::fibers::condition_variable cond;
+    bool flag = false;
+    boost::fibers::use_handoff( true);
+    std::unique_lock< boost::fibers::mutex > lk( mtx);
+    boost::fibers::fiber f( [&mtx,&cond,&flag,&order](){
+                                // blocks on mtx
+                                std::unique_lock< boost::fibers::mutex > lk( mtx);
+                                order.push_back( 1);
+                                flag = true;
+                                cond.notify_one();
+                            });
+    // let f block on mtx
+    boost::this_fiber::yield();
+    // releases mtx to f while this fiber is enqueued on cond
+    cond.wait( lk, [&flag](){ return flag; });
+    order.push_back( 2);
+    lk.unlock();
+    f.join();
+    boost::fibers::use_handoff( false);
+    BOOST_REQUIRE_EQUAL( 2u, order.size() );
+    BOOST_CHECK_EQUAL( 1, order[0]);
+    BOOST_CHECK_EQUAL( 2, order[1]);
+}
+
 boost::unit_test::test_suite * init_unit_test_suite( int, char* [])
 {
     boost::unit_test::test_suite * test =
@@ -498,6 +553,8 @@ boost::unit_test::test_suite * init_unit_test_suite( int, char* [])
     test->add( BOOST_TEST_CASE( & test_condition_wait_until_pred) );
     test->add( BOOST_TEST_CASE( & test_condition_wait_for) );
     test->add( BOOST_TEST_CASE( & test_condition_wait_for_pred) );
+    test->add( BOOST_TEST_CASE( & test_notify_one_handoff) );
+    test->add( BOOST_TEST_CASE( & test_wait_handoff) );
 
 	return test;
 }
@@ -0,0 +1,196 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+
+typedef boost::fibers::deadline_props   props_t;
+
+void test_order() {
+    std::thread( [](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::earliest_deadline_first >();
+        std::vector< int > order;
+        std::vector< boost::fibers::fiber > fibers;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        int deadlines[] = { 5, -1, 1, 3, -1, 3, 2 };
+        for ( int i = 0; i < 7; ++i) {
+            fibers.emplace_back( [&order,i](){ order.push_back( i); });
+            if ( 0 <= deadlines[i]) {
+                // requeues the ready fiber
+                fibers.back().properties< props_t >().set_deadline(
+                    now + std::chrono::milliseconds( deadlines[i]) );
+            }
+        }
+        for ( boost::fibers::fiber & f : fibers) {
+            f.join();
+        }
+        // earliest deadline first, FIFO for equal deadlines,
+        // fibers without deadline last
+        std::vector< int > expected = { 2, 6, 3, 5, 0, 1, 4 };
+        BOOST_CHECK( expected == order);
+    }).join();
+}
+
+void test_change() {
+    std::thread( [](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::earliest_deadline_first >();
+        std::vector< int > order;
+        std::vector< boost::fibers::fiber > fibers;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        for ( int i = 0; i < 5; ++i) {
+            fibers.emplace_back( [&order,i](){ order.push_back( i); });
+            fibers.back().properties< props_t >().set_deadline(
+                now + std::chrono::milliseconds( 10 * ( i + 1) ) );
+        }
+        // move fiber 3 to the front, fiber 0 to the back
+        fibers[3].properties< props_t >().set_deadline( now);
+        fibers[0].properties< props_t >().set_deadline( now + std::chrono::seconds( 1) );
+        // fiber 1 loses its deadline
+        fibers[1].properties< props_t >().clear_deadline();
+        BOOST_CHECK( ! fibers[1].properties< props_t >().has_deadline() );
+        for ( boost::fibers::fiber & f : fibers) {
+            f.join();
+        }
+        std::vector< int > expected = { 3, 2, 4, 0, 1 };
+        BOOST_CHECK( expected == order);
+    }).join();
+}
+
+void test_heap() {
+    std::thread( [](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::earliest_deadline_first >();
+        std::vector< int > keys;
+        std::vector< int > order;
+        std::vector< boost::fibers::fiber > fibers;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::srand( 42);
+        for ( int i = 0; i < 500; ++i) {
+            int key = std::rand() % 1000;
+            keys.push_back( key);
+            fibers.emplace_back( [&order,&keys,i](){ order.push_back( keys[i]); });
+            fibers.back().properties< props_t >().set_deadline(
+                now + std::chrono::microseconds( key) );
+        }
+        // change some deadlines of fibers inside the heap
+        for ( int i = 0; i < 500; i += 7) {
+            int key = std::rand() % 1000;
+            keys[i] = key;
+            fibers[i].properties< props_t >().set_deadline(
+                now + std::chrono::microseconds( key) );
+        }
+        for ( boost::fibers::fiber & f : fibers) {
+            f.join();
+        }
+        std::sort( keys.begin(), keys.end() );
+        BOOST_CHECK( keys == order);
+    }).join();
+}
+
+void test_running_fiber() {
+    std::thread( [](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::earliest_deadline_first >();
+        std::vector< int > order;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        boost::fibers::fiber f1( [&order,now](){
+                                    // not in the ready-queue: applied when
+                                    // the fiber becomes ready again
+                                    boost::this_fiber::properties< props_t >().set_deadline(
+                                        now + std::chrono::seconds( 1) );
+                                    boost::this_fiber::yield();
+                                    order.push_back( 1);
+                                 });
+        boost::fibers::fiber f2( [&order](){ order.push_back( 2); });
+        boost::fibers::fiber f3( [&order](){ order.push_back( 3); });
+        f1.properties< props_t >().set_deadline( now);
+        f2.properties< props_t >().set_deadline( now + std::chrono::milliseconds( 1) );
+        f3.properties< props_t >().set_deadline( now + std::chrono::milliseconds( 2) );
+        f1.join();
+        f2.join();
+        f3.join();
+        std::vector< int > expected = { 2, 3, 1 };
+        BOOST_CHECK( expected == order);
+    }).join();
+}
+
+void test_no_starvation() {
+    std::thread( [](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::earliest_deadline_first >();
+        // a fiber with deadline keeps yielding, sleeping fibers
+        // are woken up nevertheless
+        bool done = false;
+        boost::fibers::fiber f1( [&done](){
+                                    boost::this_fiber::sleep_for( std::chrono::milliseconds( 10) );
+                                    done = true;
+                                 });
+        boost::fibers::fiber f2( [&done](){
+                                    while ( ! done) {
+                                        boost::this_fiber::yield();
+                                    }
+                                 });
+        f2.properties< props_t >().set_deadline( std::chrono::milliseconds( 1) );
+        f1.join();
+        f2.join();
+        BOOST_CHECK( done);
+    }).join();
+}
+
+void do_test_timeout_signaled( bool handoff) {
+    std::thread( [handoff](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::earliest_deadline_first >();
+        boost::fibers::context::active()->get_scheduler()->set_handoff( handoff);
+        boost::fibers::timed_mutex mtx;
+        bool locked = false;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        boost::fibers::fiber f1( [&mtx](){
+                                    mtx.lock();
+                                    // f2 blocks in try_lock_for()
+                                    boost::this_fiber::yield();
+                                    std::this_thread::sleep_for( std::chrono::milliseconds( 5) );
+                                    // the dispatcher moves the timed-out f2 into
+                                    // the heap, f1 has the earlier deadline
+                                    boost::this_fiber::yield();
+                                    // f2 is still linked into the wait-queue
+                                    mtx.unlock();
+                                 });
+        boost::fibers::fiber f2( [&mtx,&locked](){
+                                    locked = mtx.try_lock_for( std::chrono::milliseconds( 1) );
+                                    if ( locked) {
+                                        mtx.unlock();
+                                    }
+                                 });
+        f1.properties< props_t >().set_deadline( now + std::chrono::milliseconds( 1) );
+        f2.properties< props_t >().set_deadline( now + std::chrono::milliseconds( 10) );
+        f1.join();
+        f2.join();
+        // the ownership was passed before the timeout was processed
+        BOOST_CHECK( locked);
+    }).join();
+}
+
+void test_timeout_signaled() {
+    do_test_timeout_signaled( false);
+    do_test_timeout_signaled( true);
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: deadline test suite");
+
+    test->add( BOOST_TEST_CASE( & test_order) );
+    test->add( BOOST_TEST_CASE( & test_change) );
+    test->add( BOOST_TEST_CASE( & test_heap) );
+    test->add( BOOST_TEST_CASE( & test_running_fiber) );
+    test->add( BOOST_TEST_CASE( & test_no_starvation) );
+    test->add( BOOST_TEST_CASE( & test_timeout_signaled) );
+
+    return test;
+}
@@ -7,8 +7,11 @@
 // This test is based on the tests of Boost.Thread
 
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #include <boost/assert.hpp>
 #include <boost/test/unit_test.hpp>
@@ -529,6 +532,115 @@ void test_detach() {
     }
 }
 
+void test_scheduler_stats() {
+    boost::fibers::scheduler * sched = boost::fibers::context::active()->get_scheduler();
+    boost::fibers::scheduler_stats before = sched->stats();
+    boost::fibers::fiber f1( [](){
+                                boost::this_fiber::sleep_for( std::chrono::milliseconds( 50) );
+                             });
+    boost::fibers::fiber f2( [sched](){
+                                boost::this_fiber::yield();
+                                // f1 is sleeping
+                                BOOST_CHECK_EQUAL( 1u, sched->stats().sleep_queue_size);
+                             });
+    f2.join();
+    f1.join();
+    // wakeup by another thread
+    boost::fibers::promise< int > p;
+    boost::fibers::future< int > fut = p.get_future();
+    std::thread t( [&p](){
+                        std::this_thread::sleep_for( std::chrono::milliseconds( 10) );
+                        p.set_value( 1);
+                   });
+    BOOST_CHECK_EQUAL( 1, fut.get() );
+    t.join();
+    boost::fibers::scheduler_stats after = sched->stats();
+    BOOST_CHECK_EQUAL( 2u, after.fibers_created - before.fibers_created);
+    BOOST_CHECK_EQUAL( 2u, after.fibers_terminated - before.fibers_terminated);
+    BOOST_CHECK_EQUAL( 1u, after.remote_wakeups - before.remote_wakeups);
+    BOOST_CHECK_EQUAL( 0u, after.sleep_queue_size);
+    BOOST_CHECK( 2u <= after.ready_queue_high_water);
+    BOOST_CHECK( after.context_switches - before.context_switches >= 6u);
+    // main fiber waited for f1 and the thread
+    BOOST_CHECK( std::chrono::milliseconds( 40) <= after.idle_time - before.idle_time);
+}
+
+int props_destroyed = 0;
+
+class tagged_props : public boost::fibers::fiber_properties {
+public:
+    int     tag{ 0 };
+
+    tagged_props( boost::fibers::context * ctx) :
+        fiber_properties( ctx) {
+    }
+
+    ~tagged_props() {
+        ++props_destroyed;
+    }
+};
+
+class tagged_fifo : public boost::fibers::sched_algorithm_with_properties< tagged_props > {
+private:
+    boost::fibers::sched_algorithm::ready_queue_type    rqueue_{};
+    std::mutex                                          mtx_{};
+    std::condition_variable                             cnd_{};
+    bool                                                flag_{ false };
+
+public:
+    void awakened( boost::fibers::context * ctx, tagged_props &) noexcept {
+        rqueue_.push_back( * ctx);
+    }
+
+    boost::fibers::context * pick_next() noexcept {
+        if ( rqueue_.empty() ) {
+            return nullptr;
+        }
+        boost::fibers::context * ctx = & rqueue_.front();
+        rqueue_.pop_front();
+        return ctx;
+    }
+
+    bool has_ready_fibers() const noexcept {
+        return ! rqueue_.empty();
+    }
+
+    void suspend_until( std::chrono::steady_clock::time_point const& time_point) noexcept {
+        std::unique_lock< std::mutex > lk( mtx_);
+        cnd_.wait_until( lk, time_point, [this](){ return flag_; });
+        flag_ = false;
+    }
+
+    void notify() noexcept {
+        std::unique_lock< std::mutex > lk( mtx_);
+        flag_ = true;
+        lk.unlock();
+        cnd_.notify_all();
+    }
+};
+
+void test_properties_on_stack() {
+    // properties are constructed in the control block on the fiber's stack
+    std::thread t( [](){
+        boost::fibers::use_scheduling_algorithm< tagged_fifo >();
+        props_destroyed = 0;
+        for ( int i = 0; i < 10; ++i) {
+            boost::fibers::fiber f( [i](){
+                                        tagged_props & props = boost::this_fiber::properties< tagged_props >();
+                                        props.tag = i;
+                                        boost::this_fiber::yield();
+                                        BOOST_CHECK_EQUAL( i, boost::this_fiber::properties< tagged_props >().tag);
+                                        // placed above the context
+                                        BOOST_CHECK( reinterpret_cast< char * >( & props) ==
+                                                     reinterpret_cast< char * >( boost::fibers::context::active() ) + sizeof( boost::fibers::context) );
+                                    });
+            f.join();
+        }
+        BOOST_CHECK_EQUAL( 10, props_destroyed);
+    });
+    t.join();
+}
+
 boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
     boost::unit_test::test_suite * test =
         BOOST_TEST_SUITE("Boost.Fiber: fiber test suite");
@@ -552,6 +664,8 @@ boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
     test->add( BOOST_TEST_CASE( & test_sleep_for_is_interruption_point) );
     test->add( BOOST_TEST_CASE( & test_sleep_until_is_interruption_point) );
     test->add( BOOST_TEST_CASE( & test_detach) );
+    test->add( BOOST_TEST_CASE( & test_scheduler_stats) );
+    test->add( BOOST_TEST_CASE( & test_properties_on_stack) );
 
     return test;
 }
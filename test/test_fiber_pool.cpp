@@ -0,0 +1,145 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+
+// lets the dispatcher release terminated fibers
+void wait_idle( boost::fibers::fiber_pool & pool, std::size_t n) {
+    for ( int i = 0; i < 100 && pool.idle() < n; ++i) {
+        boost::this_fiber::yield();
+    }
+}
+
+void test_launch() {
+    boost::fibers::fiber_pool pool;
+    int value = 0;
+    std::string str;
+    boost::fibers::fiber f = pool.launch(
+            [&value,&str]( int i, std::string const& s){
+                value = i;
+                str = s;
+            },
+            7, std::string("abc") );
+    BOOST_CHECK( f.joinable() );
+    f.join();
+    BOOST_CHECK_EQUAL( 7, value);
+    BOOST_CHECK_EQUAL( std::string("abc"), str);
+}
+
+void test_reuse() {
+    boost::fibers::fiber_pool pool;
+    boost::fibers::fiber::id id1, id2;
+    boost::fibers::fiber f1 = pool.launch( [&id1](){ id1 = boost::this_fiber::get_id(); });
+    f1.join();
+    wait_idle( pool, 1);
+    BOOST_CHECK_EQUAL( 1u, pool.idle() );
+    boost::fibers::fiber f2 = pool.launch( [&id2](){ id2 = boost::this_fiber::get_id(); });
+    BOOST_CHECK_EQUAL( 0u, pool.idle() );
+    f2.join();
+    // same control block
+    BOOST_CHECK( id1 == id2);
+}
+
+void test_detach() {
+    boost::fibers::fiber_pool pool( 4);
+    int count = 0;
+    for ( int i = 0; i < 100; ++i) {
+        pool.launch( [&count](){
+                        boost::this_fiber::yield();
+                        ++count;
+                     }).detach();
+    }
+    while ( 100 != count) {
+        boost::this_fiber::yield();
+    }
+    wait_idle( pool, 4);
+    // at most max_idle context' are kept
+    BOOST_CHECK_EQUAL( 4u, pool.idle() );
+}
+
+void test_interrupt() {
+    boost::fibers::fiber_pool pool;
+    bool interrupted = false;
+    boost::fibers::fiber f1 = pool.launch( [](){
+                                                for (;;) {
+                                                    boost::this_fiber::interruption_point();
+                                                    boost::this_fiber::yield();
+                                                }
+                                           });
+    f1.interrupt();
+    f1.join();
+    wait_idle( pool, 1);
+    // interruption request is not passed to the next fiber
+    boost::fibers::fiber f2 = pool.launch( [&interrupted](){
+                                                interrupted = boost::this_fiber::interruption_requested();
+                                           });
+    f2.join();
+    BOOST_CHECK( ! interrupted);
+}
+
+boost::fibers::fiber_specific_ptr< int > fss;
+
+void test_fss() {
+    boost::fibers::fiber_pool pool;
+    int * value = nullptr;
+    boost::fibers::fiber f1 = pool.launch( [](){ fss.reset( new int( 1) ); });
+    f1.join();
+    wait_idle( pool, 1);
+    // fiber-specific data released by the previous fiber
+    boost::fibers::fiber f2 = pool.launch( [&value](){ value = fss.get(); });
+    f2.join();
+    BOOST_CHECK( nullptr == value);
+}
+
+void test_large_task() {
+    boost::fibers::fiber_pool pool;
+    std::array< char, 2 * BOOST_FIBERS_POOL_TASK_SIZE > a;
+    a.fill( 'x');
+    std::shared_ptr< int > p = std::make_shared< int >( 3);
+    int value = 0;
+    boost::fibers::fiber f = pool.launch( [a,p,&value](){
+                                            value = a[BOOST_FIBERS_POOL_TASK_SIZE] == 'x' ? * p : 0;
+                                          });
+    f.join();
+    BOOST_CHECK_EQUAL( 3, value);
+    // the function has been destroyed
+    BOOST_CHECK_EQUAL( 1, p.use_count() );
+}
+
+void test_pool_destroyed_first() {
+    boost::fibers::fiber f;
+    bool done = false;
+    {
+        boost::fibers::fiber_pool pool;
+        f = pool.launch( [&done](){
+                            boost::this_fiber::yield();
+                            done = true;
+                         });
+    }
+    f.join();
+    BOOST_CHECK( done);
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: fiber-pool test suite");
+
+    test->add( BOOST_TEST_CASE( & test_launch) );
+    test->add( BOOST_TEST_CASE( & test_reuse) );
+    test->add( BOOST_TEST_CASE( & test_detach) );
+    test->add( BOOST_TEST_CASE( & test_interrupt) );
+    test->add( BOOST_TEST_CASE( & test_fss) );
+    test->add( BOOST_TEST_CASE( & test_large_task) );
+    test->add( BOOST_TEST_CASE( & test_pool_destroyed_first) );
+
+    return test;
+}
@@ -224,6 +224,51 @@ void test_fss_at_the_same_adress() {
     boost::fibers::fiber( fss_at_the_same_adress).join();
 }
 
+void fss_many_keys() {
+    // more keys than slots stored inside the context
+    boost::fibers::fiber_specific_ptr<int> ptrs[3 * BOOST_FIBERS_FSS_INLINE_SLOTS];
+    for (int i=0; i<3 * BOOST_FIBERS_FSS_INLINE_SLOTS; ++i) {
+        BOOST_CHECK(!ptrs[i].get());
+        ptrs[i].reset(new int(i));
+    }
+    for (int i=0; i<3 * BOOST_FIBERS_FSS_INLINE_SLOTS; ++i) {
+        BOOST_CHECK_EQUAL(i, *ptrs[i]);
+    }
+}
+
+void test_fss_many_keys() {
+    boost::fibers::fiber( fss_many_keys).join();
+}
+
+void fss_reused_key() {
+    // f1 keeps data of a destroyed fiber_specific_ptr, a
+    // fiber_specific_ptr created later must not see it
+    boost::fibers::fiber_specific_ptr<Dummy> * local_fss =
+        new boost::fibers::fiber_specific_ptr<Dummy>(fss_custom_cleanup);
+    bool done = false;
+    boost::fibers::fiber f1([&local_fss,&done](){
+        local_fss->reset(new Dummy);
+        while (!done) {
+            boost::this_fiber::yield();
+        }
+        boost::fibers::fiber_specific_ptr<Dummy> other_fss(fss_custom_cleanup);
+        BOOST_CHECK(!other_fss.get());
+        fss_cleanup_called=false;
+        other_fss.reset(new Dummy);
+        // data of the destroyed fiber_specific_ptr released
+        BOOST_CHECK(fss_cleanup_called);
+        BOOST_CHECK(other_fss.get());
+    });
+    boost::this_fiber::yield();
+    delete local_fss;
+    done = true;
+    f1.join();
+}
+
+void test_fss_reused_key() {
+    boost::fibers::fiber( fss_reused_key).join();
+}
+
 boost::unit_test::test_suite* init_unit_test_suite(int, char*[]) {
     boost::unit_test::test_suite* test =
         BOOST_TEST_SUITE("Boost.Fiber: fss test suite");
@@ -234,6 +279,8 @@ boost::unit_test::test_suite* init_unit_test_suite(int, char*[]) {
     test->add(BOOST_TEST_CASE(test_fss_does_no_cleanup_with_null_cleanup_function));
     test->add(BOOST_TEST_CASE(test_fss_does_not_call_cleanup_after_ptr_destroyed));
     test->add(BOOST_TEST_CASE(test_fss_cleanup_not_called_for_null_pointer));
+    test->add(BOOST_TEST_CASE(test_fss_many_keys));
+    test->add(BOOST_TEST_CASE(test_fss_reused_key));
 
     return test;
 }
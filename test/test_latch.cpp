@@ -0,0 +1,110 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+
+void test_count_down() {
+    boost::fibers::latch l( 3);
+    BOOST_CHECK( ! l.try_wait() );
+    std::vector< boost::fibers::fiber > fibers;
+    for ( int i = 0; i < 3; ++i) {
+        fibers.emplace_back( [&l](){ l.count_down(); });
+    }
+    l.wait();
+    BOOST_CHECK( l.try_wait() );
+    for ( boost::fibers::fiber & f : fibers) {
+        f.join();
+    }
+}
+
+void test_wake_all() {
+    boost::fibers::latch l( 2);
+    int woken = 0;
+    std::vector< boost::fibers::fiber > fibers;
+    for ( int i = 0; i < 4; ++i) {
+        fibers.emplace_back( [&l,&woken](){
+                                l.wait();
+                                ++woken;
+                             });
+    }
+    // all fibers are waiting
+    boost::this_fiber::yield();
+    BOOST_CHECK_EQUAL( 0, woken);
+    l.count_down();
+    boost::this_fiber::yield();
+    BOOST_CHECK_EQUAL( 0, woken);
+    // wakes all fibers at once
+    l.count_down();
+    boost::this_fiber::yield();
+    BOOST_CHECK_EQUAL( 4, woken);
+    for ( boost::fibers::fiber & f : fibers) {
+        f.join();
+    }
+}
+
+void test_arrive_and_wait() {
+    boost::fibers::latch l( 3);
+    int arrived = 0;
+    std::vector< boost::fibers::fiber > fibers;
+    for ( int i = 0; i < 3; ++i) {
+        fibers.emplace_back( [&l,&arrived](){
+                                ++arrived;
+                                l.arrive_and_wait();
+                                BOOST_CHECK_EQUAL( 3, arrived);
+                             });
+    }
+    for ( boost::fibers::fiber & f : fibers) {
+        f.join();
+    }
+}
+
+void test_errors() {
+    BOOST_CHECK_THROW( boost::fibers::latch( -1), boost::fibers::fiber_error);
+    boost::fibers::latch l( 1);
+    BOOST_CHECK_THROW( l.count_down( 2), boost::fibers::fiber_error);
+    BOOST_CHECK_THROW( l.count_down( -1), boost::fibers::fiber_error);
+    l.count_down();
+    BOOST_CHECK_THROW( l.count_down(), boost::fibers::fiber_error);
+    // does not block
+    l.wait();
+}
+
+void test_mt() {
+    // the waiting fiber destroys the latch as soon as wait() returns
+    for ( int i = 0; i < 100; ++i) {
+        std::unique_ptr< boost::fibers::latch > l( new boost::fibers::latch( 4) );
+        std::vector< std::thread > threads;
+        for ( int j = 0; j < 4; ++j) {
+            threads.emplace_back( [&l](){
+                                    boost::fibers::fiber( [&l](){ l->count_down(); }).join();
+                                  });
+        }
+        l->wait();
+        l.reset();
+        for ( std::thread & t : threads) {
+            t.join();
+        }
+    }
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: latch test suite");
+
+    test->add( BOOST_TEST_CASE( & test_count_down) );
+    test->add( BOOST_TEST_CASE( & test_wake_all) );
+    test->add( BOOST_TEST_CASE( & test_arrive_and_wait) );
+    test->add( BOOST_TEST_CASE( & test_errors) );
+    test->add( BOOST_TEST_CASE( & test_mt) );
+
+    return test;
+}
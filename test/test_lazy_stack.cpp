@@ -0,0 +1,89 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+
+typedef boost::fibers::lazy_fixedsize_stack::traits_type   traits_type;
+
+// touches about n bytes of the stack
+std::size_t use_stack( std::size_t n) {
+    char volatile buffer[1024];
+    for ( std::size_t i = 0; i < sizeof( buffer); ++i) {
+        buffer[i] = static_cast< char >( i);
+    }
+    if ( sizeof( buffer) < n) {
+        std::size_t result = use_stack( n - sizeof( buffer) );
+        return result + buffer[n % sizeof( buffer)];
+    }
+    return buffer[0];
+}
+
+void test_allocate() {
+    boost::fibers::lazy_fixedsize_stack salloc( 1024 * 1024);
+    boost::context::stack_context sctx = salloc.allocate();
+    BOOST_CHECK( nullptr != sctx.sp);
+    // requested size + guard page
+    BOOST_CHECK_EQUAL( 1024 * 1024 + traits_type::page_size(), sctx.size);
+    salloc.deallocate( sctx);
+}
+
+void test_reserve() {
+    // address space is reserved, memory is committed on first use
+    boost::fibers::lazy_fixedsize_stack salloc( 64 * 1024 * 1024);
+    std::vector< boost::context::stack_context > stacks;
+    for ( int i = 0; i < 64; ++i) {
+        stacks.push_back( salloc.allocate() );
+        BOOST_CHECK( nullptr != stacks.back().sp);
+    }
+    for ( boost::context::stack_context & sctx : stacks) {
+        salloc.deallocate( sctx);
+    }
+}
+
+void test_high_watermark() {
+    boost::fibers::lazy_fixedsize_stack salloc( 1024 * 1024);
+    std::size_t size = 0, before = 0, after = 0, later = 0;
+    boost::fibers::fiber( std::allocator_arg, salloc,
+                          [&size,&before,&after,&later](){
+                              boost::fibers::context * ctx = boost::fibers::context::active();
+                              size = ctx->stack_size();
+                              before = ctx->stack_high_watermark();
+                              use_stack( 256 * 1024);
+                              after = ctx->stack_high_watermark();
+                              boost::this_fiber::yield();
+                              // pages stay resident
+                              later = ctx->stack_high_watermark();
+                          }).join();
+    BOOST_CHECK_EQUAL( 1024 * 1024 + traits_type::page_size(), size);
+#if defined(__linux__)
+    BOOST_CHECK( 0 < before);
+    BOOST_CHECK( 64 * 1024 > before);
+    BOOST_CHECK( 256 * 1024 <= after);
+    BOOST_CHECK( size > after);
+    BOOST_CHECK_EQUAL( after, later);
+#endif
+}
+
+void test_main_context() {
+    BOOST_CHECK_EQUAL( 0u, boost::fibers::context::active()->stack_size() );
+    BOOST_CHECK_EQUAL( 0u, boost::fibers::context::active()->stack_high_watermark() );
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: lazy stack test suite");
+
+    test->add( BOOST_TEST_CASE( & test_allocate) );
+    test->add( BOOST_TEST_CASE( & test_reserve) );
+    test->add( BOOST_TEST_CASE( & test_high_watermark) );
+    test->add( BOOST_TEST_CASE( & test_main_context) );
+
+    return test;
+}
@@ -52,7 +52,10 @@ void fn3( boost::fibers::timed_mutex & m) {
 
 void fn4( boost::fibers::timed_mutex & m) {
     std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
-    while ( ! m.try_lock() );
+    while ( ! m.try_lock() ) {
+        // try_lock() does not yield
+        boost::this_fiber::yield();
+    }
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
     m.unlock();
     ns d = t1 - t0 - ms(250);
@@ -107,7 +110,10 @@ void fn9( boost::fibers::recursive_timed_mutex & m) {
 
 void fn10( boost::fibers::recursive_timed_mutex & m) {
     std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
-    while (!m.try_lock()) ;
+    while ( ! m.try_lock() ) {
+        // try_lock() does not yield
+        boost::this_fiber::yield();
+    }
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
     BOOST_CHECK(m.try_lock());
     m.unlock();
@@ -165,7 +171,10 @@ void fn15( boost::fibers::recursive_mutex & m) {
 
 void fn16( boost::fibers::recursive_mutex & m) {
     std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
-    while (!m.try_lock());
+    while ( ! m.try_lock() ) {
+        // try_lock() does not yield
+        boost::this_fiber::yield();
+    }
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
     BOOST_CHECK(m.try_lock());
     m.unlock();
@@ -185,7 +194,10 @@ void fn17( boost::fibers::mutex & m) {
 
 void fn18( boost::fibers::mutex & m) {
     std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
-    while (!m.try_lock()) ;
+    while ( ! m.try_lock() ) {
+        // try_lock() does not yield
+        boost::this_fiber::yield();
+    }
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
     m.unlock();
     ns d = t1 - t0 - ms(250);
@@ -434,6 +446,68 @@ void test_recursive_timed_mutex() {
     boost::fibers::fiber( & do_test_recursive_timed_mutex).join();
 }
 
+template< typename M >
+void do_test_handoff() {
+    std::vector< int > order;
+    M mtx;
+    boost::fibers::use_handoff( true);
+    mtx.lock();
+    boost::fibers::fiber f( [&mtx,&order](){
+                                mtx.lock();
+                                order.push_back( 2);
+                                mtx.unlock();
+                            });
+    // let f block on mtx
+    boost::this_fiber::yield();
+    // f is resumed by unlock()
+    mtx.unlock();
+    order.push_back( 1);
+    f.join();
+    boost::fibers::use_handoff( false);
+    BOOST_REQUIRE_EQUAL( 2u, order.size() );
+    BOOST_CHECK_EQUAL( 2, order[0]);
+    BOOST_CHECK_EQUAL( 1, order[1]);
+}
+
+void test_handoff() {
+    do_test_handoff< boost::fibers::mutex >();
+    do_test_handoff< boost::fibers::recursive_mutex >();
+    do_test_handoff< boost::fibers::timed_mutex >();
+    do_test_handoff< boost::fibers::recursive_timed_mutex >();
+}
+
+template< typename Mtx >
+void do_test_try_lock_no_yield() {
+    Mtx mtx;
+    bool ran = false;
+    mtx.lock();
+    boost::fibers::fiber f1( [&mtx,&ran](){
+                                // mutex is owned by the other fiber
+                                BOOST_CHECK( ! mtx.try_lock() );
+                                // f2 is ready but has not been resumed
+                                BOOST_CHECK( ! ran);
+                             });
+    boost::fibers::fiber f2( [&ran](){
+                                ran = true;
+                             });
+    f1.join();
+    f2.join();
+    BOOST_CHECK( ran);
+    mtx.unlock();
+    // uncontended
+    BOOST_CHECK( mtx.try_lock() );
+    mtx.unlock();
+}
+
+void test_try_lock_no_yield() {
+    boost::fibers::fiber( [](){
+                            do_test_try_lock_no_yield< boost::fibers::mutex >();
+                            do_test_try_lock_no_yield< boost::fibers::recursive_mutex >();
+                            do_test_try_lock_no_yield< boost::fibers::timed_mutex >();
+                            do_test_try_lock_no_yield< boost::fibers::recursive_timed_mutex >();
+                          }).join();
+}
+
 boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
     boost::unit_test::test_suite * test =
         BOOST_TEST_SUITE("Boost.Fiber: mutex test suite");
@@ -442,6 +516,8 @@ boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
     test->add( BOOST_TEST_CASE( & test_recursive_mutex) );
     test->add( BOOST_TEST_CASE( & test_timed_mutex) );
     test->add( BOOST_TEST_CASE( & test_recursive_timed_mutex) );
+    test->add( BOOST_TEST_CASE( & test_handoff) );
+    test->add( BOOST_TEST_CASE( & test_try_lock_no_yield) );
 
 	return test;
 }
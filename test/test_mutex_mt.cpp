@@ -9,6 +9,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <stdexcept>
 #include <vector>
 
@@ -68,6 +69,50 @@ void test_mutex() {
     }
 }
 
+void test_adaptive_mutex() {
+    for ( int i = 0; i < 10; ++i) {
+        boost::fibers::mutex mtx{ boost::fibers::adaptive_spin };
+        mtx.lock();
+        boost::barrier b( 3);
+        boost::thread t1( fn1< boost::fibers::mutex >, std::ref( b), std::ref( mtx) );
+        boost::thread t2( fn2< boost::fibers::mutex >, std::ref( b), std::ref( mtx) );
+        b.wait();
+        boost::this_thread::sleep_for( ms( 250) );
+        mtx.unlock();
+        t1.join();
+        t2.join();
+        BOOST_CHECK( 3 == value1);
+        BOOST_CHECK( 7 == value2);
+    }
+}
+
+void test_adaptive_mutex_contention() {
+    // short critical sections, owners running in other threads
+    boost::fibers::mutex mtx{ boost::fibers::adaptive_spin };
+    int counter = 0;
+    std::vector< boost::thread > threads;
+    for ( int i = 0; i < 4; ++i) {
+        threads.emplace_back( [&mtx,&counter](){
+                                std::vector< boost::fibers::fiber > fibers;
+                                for ( int j = 0; j < 4; ++j) {
+                                    fibers.emplace_back( [&mtx,&counter](){
+                                                            for ( int k = 0; k < 2000; ++k) {
+                                                                std::unique_lock< boost::fibers::mutex > lk( mtx);
+                                                                ++counter;
+                                                            }
+                                                         });
+                                }
+                                for ( boost::fibers::fiber & f : fibers) {
+                                    f.join();
+                                }
+                              });
+    }
+    for ( boost::thread & t : threads) {
+        t.join();
+    }
+    BOOST_CHECK_EQUAL( 4 * 4 * 2000, counter);
+}
+
 void test_recursive_mutex() {
     for ( int i = 0; i < 10; ++i) {
         boost::fibers::recursive_mutex mtx;
@@ -128,6 +173,8 @@ boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
 
 #if ! defined(BOOST_FIBERS_NO_ATOMICS)
     test->add( BOOST_TEST_CASE( & test_mutex) );
+    test->add( BOOST_TEST_CASE( & test_adaptive_mutex) );
+    test->add( BOOST_TEST_CASE( & test_adaptive_mutex_contention) );
     test->add( BOOST_TEST_CASE( & test_recursive_mutex) );
     test->add( BOOST_TEST_CASE( & test_timed_mutex) );
     test->add( BOOST_TEST_CASE( & test_recursive_timed_mutex) );
@@ -0,0 +1,69 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+#include <boost/fiber/detail/numa.hpp>
+
+namespace detail = boost::fibers::detail;
+
+void test_topology() {
+    std::size_t nodes = detail::numa_node_count();
+    BOOST_CHECK( 0 < nodes);
+    BOOST_CHECK( nodes > detail::numa_current_node() );
+    // each CPU belongs to exactly one node
+    std::set< std::size_t > cpus;
+    for ( std::size_t node = 0; node < nodes; ++node) {
+        for ( std::size_t cpu : detail::numa_node_cpus( node) ) {
+            BOOST_CHECK( cpus.insert( cpu).second);
+            BOOST_CHECK_EQUAL( node, detail::numa_node_of_cpu( cpu) );
+        }
+    }
+    BOOST_CHECK( ! cpus.empty() );
+    BOOST_CHECK( detail::numa_node_cpus( nodes).empty() );
+}
+
+void test_stack() {
+    boost::fibers::numa_fixedsize_stack salloc( 256 * 1024);
+    boost::context::stack_context sctx = salloc.allocate();
+    BOOST_CHECK( nullptr != sctx.sp);
+    salloc.deallocate( sctx);
+    // explicit node
+    boost::fibers::numa_fixedsize_stack salloc0( 256 * 1024, 0);
+    sctx = salloc0.allocate();
+    BOOST_CHECK( nullptr != sctx.sp);
+    salloc0.deallocate( sctx);
+}
+
+void test_fiber() {
+    boost::fibers::numa_fixedsize_stack salloc;
+    for ( int i = 0; i < 100; ++i) {
+        int value = 0;
+        boost::fibers::fiber f( std::allocator_arg, salloc,
+                                [&value](){
+                                    boost::this_fiber::yield();
+                                    value = 7;
+                                });
+        f.join();
+        BOOST_CHECK_EQUAL( 7, value);
+    }
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: numa test suite");
+
+    test->add( BOOST_TEST_CASE( & test_topology) );
+    test->add( BOOST_TEST_CASE( & test_stack) );
+    test->add( BOOST_TEST_CASE( & test_fiber) );
+
+    return test;
+}
@@ -0,0 +1,106 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+
+template< typename StackAllocator >
+void test_reuse() {
+    StackAllocator salloc( StackAllocator::traits_type::default_size(), 4, 2, 0);
+    boost::context::stack_context sctx = salloc.allocate();
+    void * sp = sctx.sp;
+    salloc.deallocate( sctx);
+    // stack is taken from the free list of this thread
+    sctx = salloc.allocate();
+    BOOST_CHECK_EQUAL( sp, sctx.sp);
+    salloc.deallocate( sctx);
+}
+
+template< typename StackAllocator >
+void test_watermarks() {
+    // high-watermark 4, low-watermark 2, global pool 3
+    StackAllocator salloc( StackAllocator::traits_type::default_size(), 4, 2, 3);
+    std::vector< boost::context::stack_context > stacks;
+    for ( int i = 0; i < 8; ++i) {
+        stacks.push_back( salloc.allocate() );
+    }
+    std::set< void * > sps;
+    for ( boost::context::stack_context & sctx : stacks) {
+        sps.insert( sctx.sp);
+    }
+    BOOST_CHECK_EQUAL( 8u, sps.size() );
+    // 5th stack exceeds high-watermark: 3 stacks are moved to the global pool,
+    // 8th stack: global pool is full, 3 stacks are deallocated
+    for ( boost::context::stack_context & sctx : stacks) {
+        salloc.deallocate( sctx);
+    }
+    // another thread gets stacks from the global pool
+    std::thread( [salloc,&sps]() mutable {
+                    std::vector< boost::context::stack_context > stacks;
+                    for ( int i = 0; i < 3; ++i) {
+                        stacks.push_back( salloc.allocate() );
+                        BOOST_CHECK( 0 != sps.count( stacks.back().sp) );
+                    }
+                    for ( boost::context::stack_context & sctx : stacks) {
+                        salloc.deallocate( sctx);
+                    }
+                 }).join();
+}
+
+template< typename StackAllocator >
+void test_fiber() {
+    StackAllocator salloc;
+    for ( int i = 0; i < 100; ++i) {
+        int value = 0;
+        boost::fibers::fiber f( std::allocator_arg, salloc,
+                                [&value](){
+                                    boost::this_fiber::yield();
+                                    value = 7;
+                                });
+        f.join();
+        BOOST_CHECK_EQUAL( 7, value);
+    }
+}
+
+void test_fiber_mt() {
+    // stacks deallocated by other threads
+    boost::fibers::pooled_fixedsize_stack salloc;
+    std::vector< std::thread > threads;
+    for ( int i = 0; i < 4; ++i) {
+        threads.emplace_back( [salloc](){
+                                for ( int j = 0; j < 100; ++j) {
+                                    boost::fibers::fiber( std::allocator_arg, salloc,
+                                                          [](){
+                                                              boost::this_fiber::yield();
+                                                          }).join();
+                                }
+                              });
+    }
+    for ( std::thread & t : threads) {
+        t.join();
+    }
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: pooled stack test suite");
+
+    test->add( BOOST_TEST_CASE( & test_reuse< boost::fibers::pooled_fixedsize_stack >) );
+    test->add( BOOST_TEST_CASE( & test_reuse< boost::fibers::protected_pooled_fixedsize_stack >) );
+    test->add( BOOST_TEST_CASE( & test_watermarks< boost::fibers::pooled_fixedsize_stack >) );
+    test->add( BOOST_TEST_CASE( & test_watermarks< boost::fibers::protected_pooled_fixedsize_stack >) );
+    test->add( BOOST_TEST_CASE( & test_fiber< boost::fibers::pooled_fixedsize_stack >) );
+    test->add( BOOST_TEST_CASE( & test_fiber< boost::fibers::protected_pooled_fixedsize_stack >) );
+#if ! defined(BOOST_FIBERS_NO_ATOMICS)
+    test->add( BOOST_TEST_CASE( & test_fiber_mt) );
+#endif
+
+    return test;
+}
@@ -0,0 +1,139 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+
+typedef boost::fibers::priority_props   props_t;
+
+void test_order() {
+    std::thread( [](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::priority_round_robin >();
+        std::vector< int > order;
+        std::vector< boost::fibers::fiber > fibers;
+        int priorities[] = { 3, 1, 7, 3, 0, 7 };
+        for ( int i = 0; i < 6; ++i) {
+            fibers.emplace_back( [&order,i](){ order.push_back( i); });
+            // requeues the ready fiber
+            fibers.back().properties< props_t >().set_priority( priorities[i]);
+        }
+        for ( boost::fibers::fiber & f : fibers) {
+            f.join();
+        }
+        // highest priority first, FIFO within a level
+        std::vector< int > expected = { 2, 5, 0, 3, 1, 4 };
+        BOOST_CHECK( expected == order);
+    }).join();
+}
+
+void test_round_robin() {
+    std::thread( [](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::priority_round_robin >();
+        std::vector< int > order;
+        boost::fibers::fiber f1( [&order](){
+                                    for ( int i = 0; i < 3; ++i) {
+                                        order.push_back( 1);
+                                        boost::this_fiber::yield();
+                                    }
+                                 });
+        boost::fibers::fiber f2( [&order](){
+                                    for ( int i = 0; i < 3; ++i) {
+                                        order.push_back( 2);
+                                        boost::this_fiber::yield();
+                                    }
+                                 });
+        f1.properties< props_t >().set_priority( 5);
+        f2.properties< props_t >().set_priority( 5);
+        f1.join();
+        f2.join();
+        std::vector< int > expected = { 1, 2, 1, 2, 1, 2 };
+        BOOST_CHECK( expected == order);
+    }).join();
+}
+
+void test_clamp() {
+    std::thread( [](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::priority_round_robin >();
+        std::vector< int > order;
+        boost::fibers::fiber f1( [&order](){ order.push_back( 1); });
+        boost::fibers::fiber f2( [&order](){ order.push_back( 2); });
+        boost::fibers::fiber f3( [&order](){ order.push_back( 3); });
+        f1.properties< props_t >().set_priority( -10);
+        f2.properties< props_t >().set_priority( boost::fibers::priority_round_robin::levels - 1);
+        f3.properties< props_t >().set_priority( 1000);
+        BOOST_CHECK_EQUAL( 1000, f3.properties< props_t >().get_priority() );
+        f1.join();
+        f2.join();
+        f3.join();
+        // f2 and f3 share the highest level
+        std::vector< int > expected = { 2, 3, 1 };
+        BOOST_CHECK( expected == order);
+    }).join();
+}
+
+void test_running_fiber() {
+    std::thread( [](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::priority_round_robin >();
+        std::vector< int > order;
+        boost::fibers::fiber f1( [&order](){
+                                    // not in the ready-queue: applied when
+                                    // the fiber becomes ready again
+                                    boost::this_fiber::properties< props_t >().set_priority( 0);
+                                    boost::this_fiber::yield();
+                                    order.push_back( 1);
+                                 });
+        boost::fibers::fiber f2( [&order](){ order.push_back( 2); });
+        boost::fibers::fiber f3( [&order](){ order.push_back( 3); });
+        f1.properties< props_t >().set_priority( 9);
+        f2.properties< props_t >().set_priority( 5);
+        f3.properties< props_t >().set_priority( 3);
+        f1.join();
+        f2.join();
+        f3.join();
+        std::vector< int > expected = { 2, 3, 1 };
+        BOOST_CHECK( expected == order);
+    }).join();
+}
+
+void test_no_starvation() {
+    std::thread( [](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::priority_round_robin >();
+        // a fiber of high priority keeps yielding, sleeping fibers
+        // are woken up nevertheless
+        bool done = false;
+        boost::fibers::fiber f1( [&done](){
+                                    boost::this_fiber::sleep_for( std::chrono::milliseconds( 10) );
+                                    done = true;
+                                 });
+        boost::fibers::fiber f2( [&done](){
+                                    while ( ! done) {
+                                        boost::this_fiber::yield();
+                                    }
+                                 });
+        f1.properties< props_t >().set_priority( 20);
+        f2.properties< props_t >().set_priority( 10);
+        f1.join();
+        f2.join();
+        BOOST_CHECK( done);
+    }).join();
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: priority test suite");
+
+    test->add( BOOST_TEST_CASE( & test_order) );
+    test->add( BOOST_TEST_CASE( & test_round_robin) );
+    test->add( BOOST_TEST_CASE( & test_clamp) );
+    test->add( BOOST_TEST_CASE( & test_running_fiber) );
+    test->add( BOOST_TEST_CASE( & test_no_starvation) );
+
+    return test;
+}
@@ -0,0 +1,180 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+#include <boost/fiber/detail/numa.hpp>
+
+#if defined(__linux__)
+extern "C" {
+#include <sched.h>
+}
+#endif
+
+void test_post() {
+    std::atomic< int > count{ 0 };
+    {
+        boost::fibers::runtime rt( 4);
+        BOOST_CHECK_EQUAL( 4u, rt.size() );
+        for ( int i = 0; i < 1000; ++i) {
+            rt.post( [&count](){
+                        boost::this_fiber::yield();
+                        ++count;
+                     });
+        }
+    }
+    BOOST_CHECK_EQUAL( 1000, count.load() );
+}
+
+void test_post_to() {
+    boost::fibers::runtime rt( 3);
+    std::vector< std::thread::id > ids( rt.size() );
+    std::vector< boost::fibers::future< std::thread::id > > futures;
+    for ( std::size_t i = 0; i < rt.size(); ++i) {
+        for ( int j = 0; j < 10; ++j) {
+            boost::fibers::promise< std::thread::id > p;
+            futures.push_back( p.get_future() );
+            rt.post_to( i,
+                        []( boost::fibers::promise< std::thread::id > & p){
+                            p.set_value( std::this_thread::get_id() );
+                        },
+                        std::move( p) );
+        }
+    }
+    // all fibers posted to a thread run in this thread
+    std::set< std::thread::id > threads;
+    for ( std::size_t i = 0; i < rt.size(); ++i) {
+        std::thread::id id = futures[i * 10].get();
+        for ( int j = 1; j < 10; ++j) {
+            BOOST_CHECK( id == futures[i * 10 + j].get() );
+        }
+        threads.insert( id);
+    }
+    BOOST_CHECK_EQUAL( rt.size(), threads.size() );
+    BOOST_CHECK( 0 == threads.count( std::this_thread::get_id() ) );
+}
+
+void test_submit() {
+    boost::fibers::runtime rt( 2);
+    boost::fibers::future< int > f = rt.submit( []( int i){ return 2 * i; }, 21);
+    BOOST_CHECK_EQUAL( 42, f.get() );
+}
+
+void test_drain() {
+    // fibers launched by posted functions are waited for
+    std::atomic< int > count{ 0 };
+    {
+        boost::fibers::runtime rt( 2);
+        for ( int i = 0; i < 10; ++i) {
+            rt.post( [&count](){
+                        for ( int j = 0; j < 10; ++j) {
+                            boost::fibers::fiber( [&count](){
+                                                    boost::this_fiber::sleep_for( std::chrono::milliseconds( 10) );
+                                                    ++count;
+                                                  }).detach();
+                        }
+                     });
+        }
+    }
+    BOOST_CHECK_EQUAL( 100, count.load() );
+}
+
+void test_close() {
+    boost::fibers::runtime rt( 1);
+    std::atomic< int > count{ 0 };
+    rt.post( [&count](){ ++count; });
+    rt.close();
+    BOOST_CHECK_THROW( rt.post( [&count](){ ++count; }), boost::fibers::fiber_error);
+    rt.join();
+    BOOST_CHECK_EQUAL( 1, count.load() );
+}
+
+void test_init() {
+    std::mutex mtx;
+    std::set< std::size_t > indices;
+    std::atomic< int > count{ 0 };
+    {
+        std::shared_ptr< boost::fibers::work_stealing_group > group =
+            std::make_shared< boost::fibers::work_stealing_group >( 3);
+        boost::fibers::runtime rt( 3, false,
+                                   [group,&mtx,&indices]( std::size_t idx){
+                                       boost::fibers::use_scheduling_algorithm< boost::fibers::work_stealing >( group);
+                                       std::unique_lock< std::mutex > lk( mtx);
+                                       indices.insert( idx);
+                                   });
+        for ( int i = 0; i < 100; ++i) {
+            rt.post( [&count](){
+                        boost::this_fiber::yield();
+                        ++count;
+                     });
+        }
+    }
+    BOOST_CHECK_EQUAL( 3u, indices.size() );
+    BOOST_CHECK_EQUAL( 100, count.load() );
+}
+
+#if defined(__linux__)
+void test_pin() {
+    boost::fibers::runtime rt( 2, true);
+    // CPUs are assigned node by node
+    std::vector< std::size_t > cpus;
+    for ( std::size_t node = 0; node < boost::fibers::detail::numa_node_count(); ++node) {
+        std::vector< std::size_t > node_cpus = boost::fibers::detail::numa_node_cpus( node);
+        cpus.insert( cpus.end(), node_cpus.begin(), node_cpus.end() );
+    }
+    if ( cpus.empty() ) {
+        cpus.push_back( 0);
+    }
+    // pinning to a CPU outside of the cpuset of the process fails silently
+    cpu_set_t allowed;
+    CPU_ZERO( & allowed);
+    BOOST_REQUIRE_EQUAL( 0, ::sched_getaffinity( 0, sizeof( allowed), & allowed) );
+    for ( std::size_t i = 0; i < rt.size(); ++i) {
+        boost::fibers::promise< cpu_set_t > p;
+        boost::fibers::future< cpu_set_t > f = p.get_future();
+        rt.post_to( i,
+                    []( boost::fibers::promise< cpu_set_t > & p){
+                        cpu_set_t set;
+                        CPU_ZERO( & set);
+                        ::sched_getaffinity( 0, sizeof( set), & set);
+                        p.set_value( set);
+                    },
+                    std::move( p) );
+        cpu_set_t set = f.get();
+        std::size_t cpu = cpus[i % cpus.size()];
+        if ( CPU_ISSET( cpu, & allowed) ) {
+            BOOST_CHECK_EQUAL( 1, CPU_COUNT( & set) );
+            BOOST_CHECK( CPU_ISSET( cpu, & set) );
+        }
+    }
+}
+#endif
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: runtime test suite");
+
+    test->add( BOOST_TEST_CASE( & test_post) );
+    test->add( BOOST_TEST_CASE( & test_post_to) );
+    test->add( BOOST_TEST_CASE( & test_submit) );
+    test->add( BOOST_TEST_CASE( & test_drain) );
+    test->add( BOOST_TEST_CASE( & test_close) );
+    test->add( BOOST_TEST_CASE( & test_init) );
+#if defined(__linux__)
+    test->add( BOOST_TEST_CASE( & test_pin) );
+#endif
+
+    return test;
+}
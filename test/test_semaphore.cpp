@@ -0,0 +1,150 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+
+typedef std::chrono::milliseconds ms;
+
+void test_try_acquire() {
+    boost::fibers::counting_semaphore sem( 2);
+    BOOST_CHECK( sem.try_acquire() );
+    BOOST_CHECK( sem.try_acquire() );
+    BOOST_CHECK( ! sem.try_acquire() );
+    sem.release();
+    BOOST_CHECK( sem.try_acquire() );
+    BOOST_CHECK( ! sem.try_acquire() );
+}
+
+void test_acquire() {
+    boost::fibers::counting_semaphore sem( 0);
+    bool acquired = false;
+    boost::fibers::fiber f( [&sem,&acquired](){
+                                sem.acquire();
+                                acquired = true;
+                            });
+    boost::this_fiber::yield();
+    BOOST_CHECK( ! acquired);
+    sem.release();
+    f.join();
+    BOOST_CHECK( acquired);
+    // the permit has been passed to f
+    BOOST_CHECK( ! sem.try_acquire() );
+}
+
+void test_release_n() {
+    boost::fibers::counting_semaphore sem( 0);
+    int acquired = 0;
+    std::vector< boost::fibers::fiber > fibers;
+    for ( int i = 0; i < 5; ++i) {
+        fibers.emplace_back( [&sem,&acquired](){
+                                sem.acquire();
+                                ++acquired;
+                             });
+    }
+    // all fibers are waiting
+    boost::this_fiber::yield();
+    BOOST_CHECK_EQUAL( 0, acquired);
+    // wakes three fibers at once
+    sem.release( 3);
+    boost::this_fiber::yield();
+    BOOST_CHECK_EQUAL( 3, acquired);
+    BOOST_CHECK( ! sem.try_acquire() );
+    sem.release( 3);
+    for ( boost::fibers::fiber & f : fibers) {
+        f.join();
+    }
+    BOOST_CHECK_EQUAL( 5, acquired);
+    // one permit was not needed
+    BOOST_CHECK( sem.try_acquire() );
+    BOOST_CHECK( ! sem.try_acquire() );
+}
+
+void test_limit() {
+    boost::fibers::counting_semaphore sem( 2);
+    int active = 0, max_active = 0;
+    std::vector< boost::fibers::fiber > fibers;
+    for ( int i = 0; i < 6; ++i) {
+        fibers.emplace_back( [&sem,&active,&max_active](){
+                                sem.acquire();
+                                ++active;
+                                max_active = (std::max)( max_active, active);
+                                boost::this_fiber::yield();
+                                --active;
+                                sem.release();
+                             });
+    }
+    for ( boost::fibers::fiber & f : fibers) {
+        f.join();
+    }
+    BOOST_CHECK_EQUAL( 2, max_active);
+}
+
+void test_timed() {
+    boost::fibers::counting_semaphore sem( 0);
+    BOOST_CHECK( ! sem.try_acquire_for( ms( 20) ) );
+    boost::fibers::fiber f( [&sem](){
+                                boost::this_fiber::sleep_for( ms( 20) );
+                                sem.release();
+                            });
+    BOOST_CHECK( sem.try_acquire_for( ms( 2000) ) );
+    f.join();
+    BOOST_CHECK( ! sem.try_acquire_until( std::chrono::steady_clock::now() + ms( 20) ) );
+}
+
+void test_errors() {
+    BOOST_CHECK_THROW( boost::fibers::counting_semaphore( -1), boost::fibers::fiber_error);
+    boost::fibers::counting_semaphore sem( 0);
+    BOOST_CHECK_THROW( sem.release( -1), boost::fibers::fiber_error);
+    sem.release( boost::fibers::counting_semaphore::max() );
+    BOOST_CHECK_THROW( sem.release(), boost::fibers::fiber_error);
+}
+
+void test_mt() {
+    boost::fibers::counting_semaphore sem( 0);
+    std::vector< std::thread > threads;
+    for ( int i = 0; i < 4; ++i) {
+        threads.emplace_back( [&sem](){
+                                boost::fibers::fiber consumer( [&sem](){
+                                                                for ( int j = 0; j < 1000; ++j) {
+                                                                    sem.acquire();
+                                                                }
+                                                               });
+                                boost::fibers::fiber producer( [&sem](){
+                                                                for ( int j = 0; j < 500; ++j) {
+                                                                    sem.release( 2);
+                                                                    boost::this_fiber::yield();
+                                                                }
+                                                               });
+                                consumer.join();
+                                producer.join();
+                              });
+    }
+    for ( std::thread & t : threads) {
+        t.join();
+    }
+    BOOST_CHECK( ! sem.try_acquire() );
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: counting_semaphore test suite");
+
+    test->add( BOOST_TEST_CASE( & test_try_acquire) );
+    test->add( BOOST_TEST_CASE( & test_acquire) );
+    test->add( BOOST_TEST_CASE( & test_release_n) );
+    test->add( BOOST_TEST_CASE( & test_limit) );
+    test->add( BOOST_TEST_CASE( & test_timed) );
+    test->add( BOOST_TEST_CASE( & test_errors) );
+    test->add( BOOST_TEST_CASE( & test_mt) );
+
+    return test;
+}
@@ -0,0 +1,286 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+
+typedef std::chrono::milliseconds ms;
+
+template< typename Mtx >
+void do_test_shared() {
+    Mtx mtx;
+    int active = 0, max_active = 0;
+    std::vector< boost::fibers::fiber > fibers;
+    for ( int i = 0; i < 3; ++i) {
+        fibers.emplace_back( [&mtx,&active,&max_active](){
+                                mtx.lock_shared();
+                                ++active;
+                                max_active = (std::max)( max_active, active);
+                                boost::this_fiber::yield();
+                                --active;
+                                mtx.unlock_shared();
+                             });
+    }
+    for ( boost::fibers::fiber & f : fibers) {
+        f.join();
+    }
+    BOOST_CHECK_EQUAL( 3, max_active);
+    BOOST_CHECK( mtx.try_lock() );
+    mtx.unlock();
+}
+
+void test_shared() {
+    do_test_shared< boost::fibers::shared_mutex >();
+    do_test_shared< boost::fibers::shared_timed_mutex >();
+}
+
+template< typename Mtx >
+void do_test_exclusive() {
+    Mtx mtx;
+    bool writing = false;
+    boost::fibers::fiber w( [&mtx,&writing](){
+                                std::unique_lock< Mtx > lk( mtx);
+                                writing = true;
+                                boost::this_fiber::yield();
+                                writing = false;
+                            });
+    boost::fibers::fiber r( [&mtx,&writing](){
+                                BOOST_CHECK( ! mtx.try_lock_shared() );
+                                mtx.lock_shared();
+                                BOOST_CHECK( ! writing);
+                                mtx.unlock_shared();
+                            });
+    w.join();
+    r.join();
+}
+
+void test_exclusive() {
+    do_test_exclusive< boost::fibers::shared_mutex >();
+    do_test_exclusive< boost::fibers::shared_timed_mutex >();
+}
+
+template< typename Mtx >
+void do_test_no_writer_starvation() {
+    Mtx mtx;
+    std::string order;
+    boost::fibers::fiber r1( [&mtx,&order](){
+                                mtx.lock_shared();
+                                boost::this_fiber::yield();
+                                boost::this_fiber::yield();
+                                order += "r1";
+                                mtx.unlock_shared();
+                             });
+    boost::fibers::fiber w( [&mtx,&order](){
+                                mtx.lock();
+                                order += "w";
+                                mtx.unlock();
+                            });
+    boost::fibers::fiber r2( [&mtx,&order](){
+                                // a writer is waiting
+                                BOOST_CHECK( ! mtx.try_lock_shared() );
+                                mtx.lock_shared();
+                                order += "r2";
+                                mtx.unlock_shared();
+                             });
+    r1.join();
+    w.join();
+    r2.join();
+    BOOST_CHECK_EQUAL( std::string("r1wr2"), order);
+}
+
+void test_no_writer_starvation() {
+    do_test_no_writer_starvation< boost::fibers::shared_mutex >();
+    do_test_no_writer_starvation< boost::fibers::shared_timed_mutex >();
+}
+
+template< typename Mtx, typename ... Args >
+std::string release_order( Args && ... args) {
+    Mtx mtx{ args ... };
+    std::string order;
+    boost::fibers::fiber w1( [&mtx,&order](){
+                                mtx.lock();
+                                boost::this_fiber::yield();
+                                order += "w1";
+                                mtx.unlock();
+                             });
+    boost::fibers::fiber r( [&mtx,&order](){
+                                mtx.lock_shared();
+                                order += "r";
+                                mtx.unlock_shared();
+                            });
+    boost::fibers::fiber w2( [&mtx,&order](){
+                                mtx.lock();
+                                order += "w2";
+                                mtx.unlock();
+                             });
+    w1.join();
+    r.join();
+    w2.join();
+    return order;
+}
+
+void test_policy() {
+    // a releasing writer prefers waiting writers
+    BOOST_CHECK_EQUAL( std::string("w1w2r"), release_order< boost::fibers::shared_mutex >() );
+    BOOST_CHECK_EQUAL( std::string("w1w2r"), release_order< boost::fibers::shared_timed_mutex >() );
+    // a releasing writer starts a read phase
+    BOOST_CHECK_EQUAL( std::string("w1rw2"),
+                       release_order< boost::fibers::shared_mutex >( boost::fibers::phase_fair) );
+    BOOST_CHECK_EQUAL( std::string("w1rw2"),
+                       release_order< boost::fibers::shared_timed_mutex >( boost::fibers::phase_fair) );
+}
+
+template< typename Mtx >
+void do_test_batch_wake() {
+    Mtx mtx;
+    int active = 0, max_active = 0;
+    mtx.lock();
+    std::vector< boost::fibers::fiber > fibers;
+    for ( int i = 0; i < 4; ++i) {
+        fibers.emplace_back( [&mtx,&active,&max_active](){
+                                mtx.lock_shared();
+                                ++active;
+                                max_active = (std::max)( max_active, active);
+                                boost::this_fiber::yield();
+                                --active;
+                                mtx.unlock_shared();
+                             });
+    }
+    // all readers are waiting
+    boost::this_fiber::yield();
+    mtx.unlock();
+    // the shared ownership has been passed to all readers
+    BOOST_CHECK( ! mtx.try_lock() );
+    for ( boost::fibers::fiber & f : fibers) {
+        f.join();
+    }
+    BOOST_CHECK_EQUAL( 4, max_active);
+}
+
+void test_batch_wake() {
+    do_test_batch_wake< boost::fibers::shared_mutex >();
+    do_test_batch_wake< boost::fibers::shared_timed_mutex >();
+}
+
+void test_timed() {
+    boost::fibers::shared_timed_mutex mtx;
+    bool r1_holds = false;
+    boost::fibers::fiber r1( [&mtx,&r1_holds](){
+                                mtx.lock_shared();
+                                r1_holds = true;
+                                boost::this_fiber::sleep_for( ms( 200) );
+                                r1_holds = false;
+                                mtx.unlock_shared();
+                             });
+    boost::fibers::fiber w( [&mtx](){
+                                BOOST_CHECK( ! mtx.try_lock_for( ms( 20) ) );
+                            });
+    boost::fibers::fiber r2( [&mtx,&r1_holds](){
+                                // blocked by the waiting writer, admitted
+                                // as soon as the writer has timed out
+                                mtx.lock_shared();
+                                BOOST_CHECK( r1_holds);
+                                mtx.unlock_shared();
+                             });
+    r1.join();
+    w.join();
+    r2.join();
+    mtx.lock();
+    boost::fibers::fiber r3( [&mtx](){
+                                BOOST_CHECK( ! mtx.try_lock_shared_for( ms( 20) ) );
+                                BOOST_CHECK( mtx.try_lock_shared_for( ms( 2000) ) );
+                                mtx.unlock_shared();
+                             });
+    boost::this_fiber::sleep_for( ms( 50) );
+    mtx.unlock();
+    r3.join();
+}
+
+template< typename Mtx >
+void do_test_errors() {
+    Mtx mtx;
+    BOOST_CHECK_THROW( mtx.unlock(), boost::fibers::lock_error);
+    BOOST_CHECK_THROW( mtx.unlock_shared(), boost::fibers::lock_error);
+    mtx.lock();
+    BOOST_CHECK_THROW( mtx.lock(), boost::fibers::lock_error);
+    BOOST_CHECK_THROW( mtx.lock_shared(), boost::fibers::lock_error);
+    mtx.unlock();
+}
+
+void test_errors() {
+    do_test_errors< boost::fibers::shared_mutex >();
+    do_test_errors< boost::fibers::shared_timed_mutex >();
+}
+
+template< typename ... Args >
+void do_test_mt( Args && ... args) {
+    boost::fibers::shared_mutex mtx{ args ... };
+    int value1 = 0, value2 = 0;
+    std::atomic< int > torn{ 0 };
+    std::vector< std::thread > threads;
+    for ( int i = 0; i < 4; ++i) {
+        threads.emplace_back( [&mtx,&value1,&value2,&torn](){
+                                std::vector< boost::fibers::fiber > fibers;
+                                for ( int j = 0; j < 4; ++j) {
+                                    fibers.emplace_back( [&mtx,&value1,&value2,&torn](){
+                                                            for ( int k = 0; k < 1000; ++k) {
+                                                                if ( 0 == k % 10) {
+                                                                    std::unique_lock< boost::fibers::shared_mutex > lk( mtx);
+                                                                    ++value1;
+                                                                    boost::this_fiber::yield();
+                                                                    ++value2;
+                                                                } else {
+                                                                    mtx.lock_shared();
+                                                                    if ( value1 != value2) {
+                                                                        ++torn;
+                                                                    }
+                                                                    boost::this_fiber::yield();
+                                                                    mtx.unlock_shared();
+                                                                }
+                                                            }
+                                                         });
+                                }
+                                for ( boost::fibers::fiber & f : fibers) {
+                                    f.join();
+                                }
+                              });
+    }
+    for ( std::thread & t : threads) {
+        t.join();
+    }
+    BOOST_CHECK_EQUAL( 0, torn.load() );
+    BOOST_CHECK_EQUAL( 1600, value1);
+    BOOST_CHECK_EQUAL( 1600, value2);
+}
+
+void test_mt() {
+    do_test_mt();
+    do_test_mt( boost::fibers::phase_fair);
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: shared_mutex test suite");
+
+    test->add( BOOST_TEST_CASE( & test_shared) );
+    test->add( BOOST_TEST_CASE( & test_exclusive) );
+    test->add( BOOST_TEST_CASE( & test_no_writer_starvation) );
+    test->add( BOOST_TEST_CASE( & test_policy) );
+    test->add( BOOST_TEST_CASE( & test_batch_wake) );
+    test->add( BOOST_TEST_CASE( & test_timed) );
+    test->add( BOOST_TEST_CASE( & test_errors) );
+    test->add( BOOST_TEST_CASE( & test_mt) );
+
+    return test;
+}
@@ -0,0 +1,154 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <boost/intrusive/list.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+#include <boost/fiber/detail/timer_wheel.hpp>
+
+typedef std::chrono::steady_clock::time_point   time_point;
+typedef std::chrono::milliseconds               tick_type;
+
+struct timer {
+    typedef boost::intrusive::list_member_hook<
+        boost::intrusive::link_mode<
+            boost::intrusive::auto_unlink
+        >
+    >                                   hook_type;
+
+    hook_type       hook{};
+    time_point      tp{};
+    bool            fired{ false };
+};
+
+struct timepoint_of {
+    time_point const& operator()( timer const& t) const noexcept {
+        return t.tp;
+    }
+};
+
+typedef boost::intrusive::list<
+    timer,
+    boost::intrusive::member_hook< timer, timer::hook_type, & timer::hook >,
+    boost::intrusive::constant_time_size< false >
+>                                               list_type;
+typedef boost::fibers::detail::timer_wheel<
+    list_type, timepoint_of, tick_type
+>                                               wheel_type;
+
+void test_empty() {
+    wheel_type w;
+    BOOST_CHECK( w.empty() );
+    BOOST_CHECK( ( time_point::max)() == w.next_deadline() );
+    timer t;
+    t.tp = std::chrono::steady_clock::now() + std::chrono::seconds( 1);
+    w.insert( t);
+    BOOST_CHECK( ! w.empty() );
+    BOOST_CHECK( w.next_deadline() <= t.tp + tick_type( 1) );
+    // cancel
+    t.hook.unlink();
+    BOOST_CHECK( w.empty() );
+    BOOST_CHECK( ( time_point::max)() == w.next_deadline() );
+}
+
+void test_expire() {
+    wheel_type w;
+    time_point start = std::chrono::steady_clock::now();
+    std::minstd_rand generator( 42);
+    // deadlines covering all levels of the wheel and the overflow list
+    std::vector< std::chrono::milliseconds > offsets = {
+        std::chrono::milliseconds( -5),
+        std::chrono::milliseconds( 0),
+        std::chrono::milliseconds( 1),
+        std::chrono::milliseconds( 255),
+        std::chrono::milliseconds( 256),
+        std::chrono::milliseconds( 257),
+        std::chrono::seconds( 17),
+        std::chrono::minutes( 5),
+        std::chrono::hours( 3),
+        std::chrono::hours( 30) };
+    std::uniform_int_distribution< int > distribution( 0, 100000);
+    for ( int i = 0; i < 1000; ++i) {
+        offsets.push_back( std::chrono::milliseconds( distribution( generator) ) );
+    }
+    std::vector< timer > timers( offsets.size() );
+    for ( std::size_t i = 0; i < timers.size(); ++i) {
+        timers[i].tp = start + offsets[i];
+        w.insert( timers[i]);
+    }
+    // cancel some timers
+    for ( std::size_t i = 10; i < timers.size(); i += 7) {
+        timers[i].hook.unlink();
+    }
+    // advance time with varying steps, each timer has to fire exactly
+    // once and not before its deadline
+    time_point now = start;
+    std::uniform_int_distribution< int > step( 0, 700);
+    while ( ! w.empty() ) {
+        time_point next = w.next_deadline();
+        BOOST_REQUIRE( ( time_point::max)() != next);
+        // no timer expires before next_deadline()
+        // timers already expired fire at the current tick
+        for ( timer const& t : timers) {
+            if ( t.hook.is_linked() ) {
+                BOOST_CHECK( next <= ( std::max)( t.tp, now) + tick_type( 1) );
+            }
+        }
+        now = ( std::max)( now + std::chrono::milliseconds( step( generator) ), next);
+        w.expire( now,
+                  [now]( timer * t) {
+                      BOOST_CHECK( ! t->fired);
+                      BOOST_CHECK( t->tp <= now);
+                      BOOST_CHECK( ! t->hook.is_linked() );
+                      t->fired = true;
+                  });
+    }
+    for ( std::size_t i = 0; i < timers.size(); ++i) {
+        bool canceled = 10 <= i && 0 == ( i - 10) % 7;
+        BOOST_CHECK( canceled != timers[i].fired);
+    }
+}
+
+void test_sleep() {
+    // sleeping fibers are resumed in order of their deadlines
+    std::vector< int > order;
+    boost::fibers::fiber f1( [&order](){
+                                boost::this_fiber::sleep_for( std::chrono::milliseconds( 30) );
+                                order.push_back( 3);
+                             });
+    boost::fibers::fiber f2( [&order](){
+                                boost::this_fiber::sleep_for( std::chrono::milliseconds( 10) );
+                                order.push_back( 1);
+                             });
+    boost::fibers::fiber f3( [&order](){
+                                boost::this_fiber::sleep_for( std::chrono::milliseconds( 20) );
+                                order.push_back( 2);
+                             });
+    f1.join();
+    f2.join();
+    f3.join();
+    BOOST_REQUIRE_EQUAL( 3u, order.size() );
+    BOOST_CHECK_EQUAL( 1, order[0]);
+    BOOST_CHECK_EQUAL( 2, order[1]);
+    BOOST_CHECK_EQUAL( 3, order[2]);
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: timer-wheel test suite");
+
+    test->add( BOOST_TEST_CASE( & test_empty) );
+    test->add( BOOST_TEST_CASE( & test_expire) );
+    test->add( BOOST_TEST_CASE( & test_sleep) );
+
+    return test;
+}
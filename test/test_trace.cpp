@@ -0,0 +1,88 @@
+//          Copyright Oliver Kowalke 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+
+std::size_t count( std::vector< boost::fibers::trace_record > const& records,
+                   boost::fibers::trace_event ev,
+                   boost::fibers::fiber::id const& id) {
+    return std::count_if( records.begin(), records.end(),
+                          [ev,&id]( boost::fibers::trace_record const& r) {
+                              return ev == r.event && id == r.id;
+                          });
+}
+
+void test_disabled() {
+    BOOST_CHECK( ! boost::fibers::trace_enabled() );
+    boost::fibers::fiber( [](){ boost::this_fiber::yield(); }).join();
+    BOOST_CHECK( boost::fibers::trace_collect().empty() );
+}
+
+void test_events() {
+    boost::fibers::trace_enable();
+    boost::fibers::fiber f( [](){
+                                boost::this_fiber::yield();
+                                boost::this_fiber::sleep_for( std::chrono::milliseconds( 10) );
+                            });
+    boost::fibers::fiber::id id = f.get_id();
+    f.join();
+    // wakeup by another thread
+    boost::fibers::promise< int > p;
+    boost::fibers::future< int > fut = p.get_future();
+    std::thread t( [&p](){
+                        std::this_thread::sleep_for( std::chrono::milliseconds( 10) );
+                        p.set_value( 1);
+                   });
+    BOOST_CHECK_EQUAL( 1, fut.get() );
+    t.join();
+    boost::fibers::trace_enable( false);
+    std::vector< boost::fibers::trace_record > records = boost::fibers::trace_collect();
+#if defined(BOOST_FIBERS_ENABLE_TRACE)
+    BOOST_CHECK_EQUAL( 1u, count( records, boost::fibers::trace_event::create, id) );
+    BOOST_CHECK_EQUAL( 1u, count( records, boost::fibers::trace_event::yield, id) );
+    BOOST_CHECK_EQUAL( 1u, count( records, boost::fibers::trace_event::sleep, id) );
+    BOOST_CHECK_EQUAL( 1u, count( records, boost::fibers::trace_event::terminate, id) );
+    // started, yielded, woken up from sleep
+    BOOST_CHECK_EQUAL( 3u, count( records, boost::fibers::trace_event::ready, id) );
+    BOOST_CHECK_EQUAL( 3u, count( records, boost::fibers::trace_event::resume, id) );
+    BOOST_CHECK_EQUAL( 3u, count( records, boost::fibers::trace_event::suspend, id) );
+    boost::fibers::fiber::id main_id = boost::this_fiber::get_id();
+    BOOST_CHECK_EQUAL( 1u, count( records, boost::fibers::trace_event::remote_wakeup, main_id) );
+    // ordered by time
+    BOOST_CHECK( std::is_sorted( records.begin(), records.end(),
+                                 []( boost::fibers::trace_record const& l, boost::fibers::trace_record const& r) {
+                                     return l.tp < r.tp;
+                                 }) );
+    // records have been removed
+    BOOST_CHECK( boost::fibers::trace_collect().empty() );
+    std::ostringstream os;
+    boost::fibers::trace_export_chrome( os, records);
+    std::string json = os.str();
+    BOOST_CHECK_EQUAL( 0u, json.find("{\"traceEvents\":[") );
+    BOOST_CHECK( std::string::npos != json.find("\"ph\":\"B\"") );
+    BOOST_CHECK( std::string::npos != json.find("\"name\":\"terminate\"") );
+#else
+    BOOST_CHECK( records.empty() );
+#endif
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: trace test suite");
+
+    test->add( BOOST_TEST_CASE( & test_disabled) );
+    test->add( BOOST_TEST_CASE( & test_events) );
+
+    return test;
+}
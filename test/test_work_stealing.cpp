@@ -0,0 +1,130 @@
+//          Copyright Oliver Kowalke 2015.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <boost/fiber/all.hpp>
+
+boost::fibers::future< int > fibonacci( int);
+
+int fibonacci_( int n) {
+    boost::this_fiber::yield();
+    int res = 1;
+    if ( 0 != n && 1 != n) {
+        boost::fibers::future< int > f1 = fibonacci( n - 1);
+        boost::fibers::future< int > f2 = fibonacci( n - 2);
+        res = f1.get() + f2.get();
+    }
+    return res;
+}
+
+boost::fibers::future< int > fibonacci( int n) {
+    boost::fibers::packaged_task< int() > pt( std::bind( fibonacci_, n) );
+    boost::fibers::future< int > f( pt.get_future() );
+    boost::fibers::fiber( std::move( pt) ).detach();
+    return f;
+}
+
+void thief( std::shared_ptr< boost::fibers::work_stealing_group > group, std::atomic< bool > * fini) {
+    boost::fibers::use_scheduling_algorithm< boost::fibers::work_stealing >( group);
+    while ( ! ( * fini) ) {
+        std::this_thread::yield();
+        boost::this_fiber::yield();
+    }
+}
+
+void test_fibonacci() {
+    std::shared_ptr< boost::fibers::work_stealing_group > group(
+            new boost::fibers::work_stealing_group( 4) );
+    std::thread( [group](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::work_stealing >( group);
+        std::atomic< bool > fini( false);
+        std::thread threads[] = {
+            std::thread( thief, group, & fini),
+            std::thread( thief, group, & fini),
+            std::thread( thief, group, & fini)
+        };
+        for ( int i = 0; i < 5; ++i) {
+            BOOST_CHECK_EQUAL( 89, fibonacci( 10).get() );
+        }
+        fini = true;
+        for ( std::thread & t : threads) {
+            t.join();
+        }
+    }).join();
+}
+
+void test_steal() {
+    std::shared_ptr< boost::fibers::work_stealing_group > group(
+            new boost::fibers::work_stealing_group( 2) );
+    std::thread( [group](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::work_stealing >( group);
+        std::atomic< bool > fini( false);
+        std::atomic< int > count( 0);
+        std::thread::id id = std::this_thread::get_id();
+        std::atomic< bool > migrated( true);
+        for ( int i = 0; i < 100; ++i) {
+            boost::fibers::fiber( [&count,&migrated,id](){
+                                    if ( std::this_thread::get_id() == id) {
+                                        migrated = false;
+                                    }
+                                    ++count;
+                                  }).detach();
+        }
+        // do not resume the fibers in this thread
+        // all fibers have to be stolen by the other thread
+        std::thread t( thief, group, & fini);
+        while ( 100 != count) {
+            std::this_thread::yield();
+        }
+        fini = true;
+        t.join();
+        BOOST_CHECK( migrated);
+    }).join();
+}
+
+void test_yield_fairness() {
+    std::shared_ptr< boost::fibers::work_stealing_group > group(
+            new boost::fibers::work_stealing_group( 1) );
+    std::thread( [group](){
+        boost::fibers::use_scheduling_algorithm< boost::fibers::work_stealing >( group);
+        bool done = false;
+        int yields = 0;
+        auto fn = [&done,&yields](){
+            while ( ! done && 100 > yields) {
+                ++yields;
+                boost::this_fiber::yield();
+            }
+        };
+        // queued before f1 and f2
+        boost::fibers::fiber f3( [&done](){ done = true; });
+        boost::fibers::fiber f1( fn);
+        boost::fibers::fiber f2( fn);
+        f1.join();
+        f2.join();
+        f3.join();
+        // f1 and f2 must not only yield to each other
+        BOOST_CHECK( 4 > yields);
+    }).join();
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Fiber: work-stealing test suite");
+
+#if ! defined(BOOST_FIBERS_NO_ATOMICS)
+    test->add( BOOST_TEST_CASE( & test_fibonacci) );
+    test->add( BOOST_TEST_CASE( & test_steal) );
+    test->add( BOOST_TEST_CASE( & test_yield_fairness) );
+#endif
+
+    return test;
+}